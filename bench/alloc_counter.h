@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// Counting allocator for the benchmarks that measure heap traffic. It replaces the global
+// operator new/delete, so include it from exactly one translation unit of a benchmark.
+//
+// The counters only cover the calling thread: allocations made by the poll thread or the
+// worker pool are not counted.
+
+struct AllocationCount {
+    unsigned long long allocations{0};
+    unsigned long long bytes{0};
+};
+
+inline thread_local AllocationCount t_allocationCount;
+
+// Allocations made by this thread so far; subtract two of these to count a stretch of code
+inline AllocationCount allocationCount() {
+    return t_allocationCount;
+}
+
+void* operator new(std::size_t size) {
+    t_allocationCount.allocations++;
+    t_allocationCount.bytes += size;
+    if (void* block = std::malloc(size ? size : 1)) return block;
+    throw std::bad_alloc();
+}
+
+// GCC flags the free() once these are inlined into a new-expression's caller, although
+// the block did come from the malloc() above
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void* block) noexcept {
+    std::free(block);
+}
+
+void operator delete(void* block, std::size_t) noexcept {
+    std::free(block);
+}
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
@@ -0,0 +1,131 @@
+// Collector CPU time, and the share of it spent timing driver calls.
+//
+// The monitor is run with default metric periods while the main thread sleeps, so the
+// process CPU time is the collector's. By default the backend is NVML on the fake driver
+// (fake_nvml.h), every call of which takes --latency-us, so driver calls go through the
+// backend's call timing as they would on hardware. --simulate=..., --replay=... or
+// GPU_MONITOR_NVML_LIBRARY (NVML, or a stub library) pick the backend the app would use.
+// The cost of timing one call (two clock reads and a histogram record, as timedCall()
+// does) is measured separately and multiplied by the number of calls the backend timed.
+//
+//   bench_collector_overhead [--seconds=10] [--gpus=8] [--processes=64] [--latency-us=20]
+//                            [--simulate=8,64 | --replay=FILE]
+
+#include "bench_common.h"
+#include "fake_nvml.h"
+#include "backend/gpu_backend.h"
+#include "backend/nvml_backend.h"
+#include "gpu_monitor.h"
+#include "latency_histogram.h"
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+// User + system CPU time of the whole process, in microseconds
+double processCpuUs() {
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user)) return 0.0;
+    auto ticks = [](const FILETIME& time) {
+        return (static_cast<unsigned long long>(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+    };
+    return static_cast<double>(ticks(kernel) + ticks(user)) / 10.0;  // 100 ns ticks
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0.0;
+    return static_cast<double>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1e6 +
+           static_cast<double>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec);
+#endif
+}
+
+// Nanoseconds timedCall() adds to a call: two clock reads and one histogram record
+double instrumentationNs() {
+    constexpr unsigned int ITERATIONS = 5000000;
+    LatencyHistogram histogram;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < ITERATIONS; i++) {
+        auto callStart = std::chrono::steady_clock::now();
+        auto elapsed = std::chrono::steady_clock::now() - callStart;
+        histogram.record(static_cast<unsigned long long>(
+            std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()));
+    }
+    std::chrono::duration<double, std::nano> total = std::chrono::steady_clock::now() - start;
+    return histogram.count() == ITERATIONS ? total.count() / ITERATIONS : 0.0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    unsigned int seconds = std::max(1u, unsignedFlag(argc, argv, "--seconds", 10));
+
+    // The fake driver unless the command line or environment picks a backend
+    std::unique_ptr<GpuBackend> backend;
+    bool backendGiven = std::any_of(argv + 1, argv + argc, [](const char* arg) {
+        return strncmp(arg, "--simulate", 10) == 0 || strncmp(arg, "--replay", 8) == 0;
+    });
+    if (backendGiven || getenv("GPU_MONITOR_NVML_LIBRARY")) {
+        std::string error;
+        backend = createBackend(argc, argv, error);
+        if (!backend) {
+            fprintf(stderr, "%s\n", error.c_str());
+            return 1;
+        }
+    } else {
+        FakeNvmlConfig config;
+        config.gpus = std::max(1u, unsignedFlag(argc, argv, "--gpus", 8));
+        config.processes = unsignedFlag(argc, argv, "--processes", 64);
+        config.callLatencyUs = unsignedFlag(argc, argv, "--latency-us", 20);
+        backend = std::make_unique<NvmlBackend>(fakeNvmlApi(config));
+        printf("fake NVML driver, %u us per call\n", config.callLatencyUs);
+    }
+    GpuMonitor monitor(std::move(backend));
+    if (!monitor.initialize()) {
+        fprintf(stderr, "Monitor failed to initialize\n");
+        return 1;
+    }
+
+    double perCallNs = instrumentationNs();
+
+    // Only the collector runs while the main thread sleeps
+    unsigned long long firstGeneration = monitor.getSnapshot()->generation;
+    unsigned long long callsBefore = 0;
+    for (const auto& call : monitor.getCallLatency()) callsBefore += call.calls;
+    double cpuBefore = processCpuUs();
+    auto wallBefore = std::chrono::steady_clock::now();
+    monitor.startPolling();
+    std::this_thread::sleep_for(std::chrono::seconds(seconds));
+    monitor.stopPolling();
+    double cpuUs = processCpuUs() - cpuBefore;
+    std::chrono::duration<double> wall = std::chrono::steady_clock::now() - wallBefore;
+    unsigned long long calls = 0;
+    for (const auto& call : monitor.getCallLatency()) calls += call.calls;
+    calls -= callsBefore;
+
+    auto snapshot = monitor.getSnapshot();
+    double cpuMsPerSecond = cpuUs / 1000.0 / wall.count();
+    double callsPerSecond = static_cast<double>(calls) / wall.count();
+    double timingMsPerSecond = callsPerSecond * perCallNs / 1e6;
+
+    printf("%zu GPUs, %.1f s, %llu polls published\n\n", snapshot->gpus.size(), wall.count(),
+           snapshot->generation - firstGeneration);
+    printf("collector CPU time         %10.3f ms/s (%.3f%% of one core)\n", cpuMsPerSecond, cpuMsPerSecond / 10.0);
+    printf("call timing cost           %10.1f ns/call\n", perCallNs);
+    if (calls == 0) {
+        printf("driver calls timed         %10s (this backend makes no driver calls)\n", "none");
+        return 0;
+    }
+    printf("driver calls timed         %10.0f /s\n", callsPerSecond);
+    printf("call timing CPU time       %10.3f ms/s (%.2f%% of collector CPU time)\n", timingMsPerSecond,
+           cpuMsPerSecond > 0.0 ? 100.0 * timingMsPerSecond / cpuMsPerSecond : 0.0);
+    return 0;
+}
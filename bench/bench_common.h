@@ -0,0 +1,40 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <numeric>
+#include <vector>
+
+// Shared helpers for the benchmarks in this directory
+
+// Value of a "--name=N" flag, or `fallback` when it is not given
+inline unsigned int unsignedFlag(int argc, char** argv, const char* name, unsigned int fallback) {
+    size_t length = strlen(name);
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], name, length) == 0 && argv[i][length] == '=') {
+            return static_cast<unsigned int>(std::strtoul(argv[i] + length + 1, nullptr, 10));
+        }
+    }
+    return fallback;
+}
+
+// Mean, median and extremes of a set of measurements
+struct Summary {
+    double mean{0.0};
+    double median{0.0};
+    double min{0.0};
+    double max{0.0};
+};
+
+inline Summary summarize(std::vector<double> values) {
+    Summary summary;
+    if (values.empty()) return summary;
+    std::ranges::sort(values);
+    summary.mean = std::accumulate(values.begin(), values.end(), 0.0) / static_cast<double>(values.size());
+    summary.median = values[values.size() / 2];
+    summary.min = values.front();
+    summary.max = values.back();
+    return summary;
+}
@@ -0,0 +1,85 @@
+// Poll wall time against the number of poll workers, through the NVML backend.
+//
+// A fake driver (fake_nvml.h) answers every call after --latency-us, so a poll costs the
+// backend's real sequence of small per-device calls, and polling devices in parallel
+// goes through the state the workers share: the calls-avoided counter, the call table
+// lookup and each device's cached state. Calls sleep through their latency like a call
+// blocked on the device; --spin makes them burn CPU instead, which then scales with the
+// cores available rather than the workers. Every metric group is due on every poll, and
+// the same monitor setup is polled with each worker count and the poll durations compared.
+//
+//   bench_poll_workers [--gpus=16] [--processes=32] [--latency-us=100] [--polls=20] [--spin=1]
+
+#include "bench_common.h"
+#include "fake_nvml.h"
+#include "backend/nvml_backend.h"
+#include "gpu_monitor.h"
+
+#include <chrono>
+#include <thread>
+
+namespace {
+
+struct Measurement {
+    std::vector<double> pollMs;  // Duration of each poll
+    double callsPerPoll{0.0};    // Driver calls answered per poll
+};
+
+// Poll durations of `polls` consecutive polls with `workers` poll workers
+Measurement measure(const FakeNvmlConfig& config, unsigned int workers, unsigned int polls) {
+    GpuMonitor monitor(std::make_unique<NvmlBackend>(fakeNvmlApi(config)));
+    monitor.setPollWorkers(workers);
+    for (int group = 0; group < METRIC_GROUP_COUNT; group++) {
+        monitor.setMetricGroupPeriod(static_cast<MetricGroup>(group), 1);  // Every group, every poll
+    }
+    if (!monitor.initialize()) return {};
+
+    // Snapshots carry the duration of the poll that published them; the initial one
+    // (enumeration included) is left out
+    Measurement result;
+    unsigned long long first = monitor.getSnapshot()->generation;
+    unsigned long long seen = first;
+    unsigned long long firstCalls = fakeNvmlCalls();
+    monitor.startPolling(1);
+    while (result.pollMs.size() < polls) {
+        auto snapshot = monitor.getSnapshot();
+        if (snapshot->generation != seen) {
+            seen = snapshot->generation;
+            result.pollMs.push_back(snapshot->captured.durationUs / 1000.0);
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    monitor.stopPolling();
+    unsigned long long published = monitor.getSnapshot()->generation - first;
+    result.callsPerPoll = static_cast<double>(fakeNvmlCalls() - firstCalls) / static_cast<double>(published);
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    FakeNvmlConfig config;
+    config.gpus = std::max(1u, unsignedFlag(argc, argv, "--gpus", 16));
+    config.processes = unsignedFlag(argc, argv, "--processes", 32);
+    config.callLatencyUs = unsignedFlag(argc, argv, "--latency-us", 100);
+    config.sleepOnCalls = unsignedFlag(argc, argv, "--spin", 0) == 0;
+    unsigned int polls = std::max(1u, unsignedFlag(argc, argv, "--polls", 20));
+
+    printf("%u fake NVML GPUs, %u processes each, %u us per driver call (%s), %u polls per worker count\n\n",
+           config.gpus, config.processes, config.callLatencyUs, config.sleepOnCalls ? "sleeping" : "spinning",
+           polls);
+    printf("%8s %12s %10s %10s %10s %10s %8s\n", "workers", "calls/poll", "mean ms", "median ms", "min ms",
+           "max ms", "speedup");
+
+    double serialMs = 0.0;
+    for (unsigned int workers = 1;; workers *= 2) {
+        workers = std::min(workers, config.gpus);
+        Measurement measurement = measure(config, workers, polls);
+        Summary poll = summarize(measurement.pollMs);
+        if (workers == 1) serialMs = poll.median;
+        printf("%8u %12.1f %10.2f %10.2f %10.2f %10.2f %7.1fx\n", workers, measurement.callsPerPoll, poll.mean,
+               poll.median, poll.min, poll.max, poll.median > 0.0 ? serialMs / poll.median : 0.0);
+        if (workers == config.gpus) break;
+    }
+    return 0;
+}
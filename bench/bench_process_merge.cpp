@@ -0,0 +1,99 @@
+// Process list reads and merging with many GPU processes, through the NVML backend.
+//
+// A fake driver (fake_nvml.h) lists --processes compute processes on one GPU. With MIG
+// (--mig=N instances) every fourth one runs on two instances and is listed twice, and
+// --mps of them are listed again as MPS clients, so the backend meets the same PID
+// several times within a list and across lists. The first poll finds the list buffer too
+// small (NVML_ERROR_INSUFFICIENT_SIZE) and grows it; later polls reuse it, and count
+// the heap allocations they make. Names given to the processes after the first poll, as
+// the monitor's process resolver would, must still be there after the last.
+//
+//   bench_process_merge [--processes=1000] [--mig=4] [--mps=100] [--polls=1000]
+
+#include "alloc_counter.h"
+#include "bench_common.h"
+#include "fake_nvml.h"
+#include "backend/nvml_backend.h"
+
+#include <chrono>
+#include <string>
+
+namespace {
+
+struct Poll {
+    double us{0.0};
+    unsigned long long calls{0};
+    unsigned long long allocations{0};
+};
+
+// Time one processes poll of device 0
+Poll pollProcesses(NvmlBackend& backend, GpuSample& sample) {
+    unsigned long long calls = fakeNvmlCalls();
+    unsigned long long allocations = allocationCount().allocations;
+    auto start = std::chrono::steady_clock::now();
+    backend.collect(0, 1u << METRIC_PROCESSES, sample);
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    return {elapsed.count(), fakeNvmlCalls() - calls, allocationCount().allocations - allocations};
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    FakeNvmlConfig config;
+    config.processes = unsignedFlag(argc, argv, "--processes", 1000);
+    config.migInstances = unsignedFlag(argc, argv, "--mig", 4);
+    config.mpsClients = std::min(config.processes, unsignedFlag(argc, argv, "--mps", 100));
+    unsigned int polls = std::max(1u, unsignedFlag(argc, argv, "--polls", 1000));
+
+    NvmlBackend backend(fakeNvmlApi(config));
+    if (!backend.initialize() || backend.enumerateDevices().empty()) {
+        fprintf(stderr, "Fake driver failed to initialize\n");
+        return 1;
+    }
+
+    // The MIG layout is read with the health group
+    GpuSample sample{};
+    backend.collect(0, 1u << METRIC_HEALTH, sample);
+
+    printf("%u processes, %zu MIG instances, %u MPS clients, %u polls\n\n", config.processes,
+           sample.migInstances.size(), config.mpsClients, polls);
+    printf("%-22s %12s %14s %13s\n", "poll", "us / poll", "driver calls", "allocations");
+
+    Poll cold = pollProcesses(backend, sample);
+    printf("%-22s %12.1f %14llu %13llu\n", "first (buffer grows)", cold.us, cold.calls, cold.allocations);
+
+    // Names longer than the small-string buffer, so a copy would show as an allocation
+    for (auto& proc : sample.processes) {
+        proc.name = "resolved-process-name-" + std::to_string(proc.pid);
+    }
+
+    std::vector<double> times;
+    times.reserve(polls);
+    unsigned long long calls = 0, allocations = 0;
+    for (unsigned int i = 0; i < polls; i++) {
+        Poll poll = pollProcesses(backend, sample);
+        times.push_back(poll.us);
+        calls += poll.calls;
+        allocations += poll.allocations;
+    }
+    Summary steady = summarize(times);
+    printf("%-22s %12.1f %14.1f %13.1f   (median %.1f, max %.1f us)\n", "steady", steady.mean,
+           static_cast<double>(calls) / polls, static_cast<double>(allocations) / polls, steady.median, steady.max);
+
+    // Every PID once, and each instance entry once per instance the process runs on
+    size_t instanceEntries = 0;
+    for (const auto& instance : sample.migInstances) {
+        instanceEntries += instance.processes.size();
+    }
+    size_t expectedEntries = sample.migInstances.size() > 1 ? config.processes + (config.processes + 3) / 4
+                                                            : (sample.migInstances.empty() ? 0 : config.processes);
+    size_t named = std::ranges::count_if(sample.processes, [](const GpuProcess& proc) {
+        return proc.name == "resolved-process-name-" + std::to_string(proc.pid);
+    });
+    printf("\n%zu merged processes (%u expected), %zu MIG instance entries (%zu expected), %zu names kept\n",
+           sample.processes.size(), config.processes, instanceEntries, expectedEntries, named);
+
+    backend.shutdown();
+    return sample.processes.size() == config.processes && instanceEntries == expectedEntries &&
+           named == sample.processes.size() ? 0 : 1;
+}
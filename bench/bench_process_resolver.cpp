@@ -0,0 +1,98 @@
+// Process resolver cost per poll with many GPU processes.
+//
+// A fake procfs tree with one directory per simulated process (stat, status, cmdline) is
+// resolved the way the monitor does on every processes poll. The first pass fills the
+// cache, later passes should be served from it without opening or reading any process
+// file; then a share of the PIDs is handed to new processes, which must be re-resolved.
+// Linux only: Windows has no procfs to fake.
+//
+//   bench_process_resolver [--processes=1000] [--passes=100] [--reused=100]
+
+#include "bench_common.h"
+#include "platform/process_resolver.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace {
+
+constexpr unsigned int FIRST_PID = 10000;
+
+// Write /<root>/<pid>/{stat,status,cmdline} for a process started at `startTime` (field 22)
+void writeProcess(const std::filesystem::path& root, unsigned int pid, unsigned long long startTime,
+                  const std::string& name) {
+    std::filesystem::path dir = root / std::to_string(pid);
+    std::filesystem::create_directories(dir);
+    std::ofstream(dir / "stat") << pid << " (" << name << ") S 1 " << pid << ' ' << pid
+                                << " 0 -1 4194560 100 0 0 0 10 5 0 0 20 0 8 0 " << startTime
+                                << " 123456789 1000 18446744073709551615\n";
+    std::ofstream(dir / "status") << "Name:\t" << name << "\nState:\tS (sleeping)\nPid:\t" << pid
+                                  << "\nUid:\t1000\t1000\t1000\t1000\nGid:\t1000\t1000\t1000\t1000\n";
+    std::string cmdline = "/usr/bin/" + name + '\0' + "--device=0" + '\0';
+    std::ofstream(dir / "cmdline", std::ios::binary) << cmdline;
+}
+
+// Resolve every simulated PID once; returns microseconds per lookup
+double resolveAll(ProcessResolver& resolver, unsigned int processes, unsigned int passes) {
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned int pass = 0; pass < passes; pass++) {
+        for (unsigned int pid = FIRST_PID; pid < FIRST_PID + processes; pid++) {
+            resolver.resolve(pid);
+        }
+    }
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / (static_cast<double>(processes) * passes);
+}
+
+void report(const char* phase, ProcessResolver& resolver, unsigned long long& reads, double usPerLookup,
+            unsigned long long lookups) {
+    unsigned long long now = resolver.reads();
+    printf("%-22s %12.2f %14.3f\n", phase, usPerLookup,
+           static_cast<double>(now - reads) / static_cast<double>(lookups));
+    reads = now;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    unsigned int processes = std::max(1u, unsignedFlag(argc, argv, "--processes", 1000));
+    unsigned int passes = std::max(1u, unsignedFlag(argc, argv, "--passes", 100));
+    unsigned int reused = std::min(processes, unsignedFlag(argc, argv, "--reused", 100));
+
+    std::filesystem::path root = std::filesystem::temp_directory_path() /
+                                 ("gpu_monitor_procfs_" + std::to_string(std::chrono::steady_clock::now()
+                                                                             .time_since_epoch().count()));
+    for (unsigned int pid = FIRST_PID; pid < FIRST_PID + processes; pid++) {
+        writeProcess(root, pid, 1000 + pid, "worker" + std::to_string(pid));
+    }
+
+    printf("%u simulated processes under %s, %u cached passes, %u PIDs reused\n\n",
+           processes, root.c_str(), passes, reused);
+    printf("%-22s %12s %14s\n", "pass", "us / lookup", "reads / lookup");
+
+    unsigned long long reads = 0;
+    {
+        ProcessResolver resolver(root.string());
+        report("cold", resolver, reads, resolveAll(resolver, processes, 1), processes);
+        report("cached", resolver, reads, resolveAll(resolver, processes, passes),
+               static_cast<unsigned long long>(processes) * passes);
+
+        // New processes on old PIDs: the directory is recreated, as procfs would
+        for (unsigned int pid = FIRST_PID; pid < FIRST_PID + reused; pid++) {
+            std::filesystem::remove_all(root / std::to_string(pid));
+            writeProcess(root, pid, 5000000 + pid, "reused" + std::to_string(pid));
+        }
+        report("after PID reuse", resolver, reads, resolveAll(resolver, processes, 1), processes);
+
+        unsigned int renamed = 0;
+        for (unsigned int pid = FIRST_PID; pid < FIRST_PID + reused; pid++) {
+            renamed += resolver.resolve(pid).name == "reused" + std::to_string(pid);
+        }
+        printf("\n%u of %u reused PIDs resolved to their new process\n", renamed, reused);
+    }
+
+    std::filesystem::remove_all(root);
+    return 0;
+}
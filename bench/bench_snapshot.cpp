@@ -0,0 +1,83 @@
+// Heap traffic of one UI frame's read of the monitor state.
+//
+// A frame used to take copies of the stats (getStats() + getSystemInfo(), and the UI
+// copied the stats again to sort the cards); it now holds the published snapshot. Both
+// reads are run against a polling monitor with simulated devices, and every allocation
+// made by the frame's thread is counted.
+//
+//   bench_snapshot [--gpus=8] [--processes=256] [--frames=10000]
+
+#include "alloc_counter.h"
+#include "bench_common.h"
+#include "backend/simulated_backend.h"
+#include "gpu_monitor.h"
+
+#include <chrono>
+
+namespace {
+
+struct FrameCost {
+    double bytes{0.0};
+    double allocations{0.0};
+    double statsCopies{0.0};
+    double us{0.0};
+};
+
+// Average cost of `frames` reads done by `read`, which returns how many GpuStats it copied
+template <typename Read>
+FrameCost measure(unsigned int frames, Read read) {
+    AllocationCount before = allocationCount();
+    unsigned long long copies = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned int frame = 0; frame < frames; frame++) {
+        copies += read();
+    }
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    AllocationCount after = allocationCount();
+
+    FrameCost cost;
+    cost.bytes = static_cast<double>(after.bytes - before.bytes) / frames;
+    cost.allocations = static_cast<double>(after.allocations - before.allocations) / frames;
+    cost.statsCopies = static_cast<double>(copies) / frames;
+    cost.us = elapsed.count() / frames;
+    return cost;
+}
+
+void report(const char* name, const FrameCost& cost) {
+    printf("%-28s %14.0f %12.1f %12.1f %10.2f\n", name, cost.bytes, cost.allocations, cost.statsCopies, cost.us);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    unsigned int gpus = std::max(1u, unsignedFlag(argc, argv, "--gpus", 8));
+    unsigned int processes = unsignedFlag(argc, argv, "--processes", 256);
+    unsigned int frames = std::max(1u, unsignedFlag(argc, argv, "--frames", 10000));
+
+    SimulatedScript script;
+    script.gpuCount = gpus;
+    script.processCount = processes;
+    GpuMonitor monitor(std::make_unique<SimulatedBackend>(script));
+    if (!monitor.initialize()) return 1;
+    monitor.startPolling(10);
+
+    printf("%u simulated GPUs, %u processes, %u frames, polling every 10 ms\n\n", gpus, processes, frames);
+    printf("%-28s %14s %12s %12s %10s\n", "frame read", "bytes / frame", "allocs", "GpuStats", "us");
+
+    // Before: copies of the stats and system info, plus the UI's sorted copy
+    report("getStats() + sort copy", measure(frames, [&] {
+        std::vector<GpuStats> stats = monitor.getStats();
+        SystemInfo system = monitor.getSystemInfo();
+        std::vector<GpuStats> sorted = stats;
+        return stats.size() + sorted.size();
+    }));
+
+    // Now: the published snapshot, held for the frame
+    report("getSnapshot()", measure(frames, [&] {
+        auto snapshot = monitor.getSnapshot();
+        return size_t{0};
+    }));
+
+    monitor.stopPolling();
+    return 0;
+}
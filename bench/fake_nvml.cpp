@@ -0,0 +1,328 @@
+#include "fake_nvml.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+// Process lists of each GPU. The compute list has config.processes PIDs. With MIG,
+// process i runs on instance i % migInstances, and every fourth one also on the next
+// instance, where the driver lists it a second time. The first mpsClients processes are
+// listed again as MPS clients. There are no graphics processes.
+
+namespace {
+
+constexpr unsigned int FIRST_PID = 100000;
+constexpr unsigned int MAX_MIG_INSTANCES = 7;
+
+FakeNvmlConfig g_config;
+std::atomic<unsigned long long> g_calls{0};
+std::vector<std::vector<nvmlProcessInfo_t>> g_computeLists;
+std::vector<std::vector<nvmlProcessInfo_t>> g_mpsLists;
+
+// Every call is counted and takes the configured latency
+void answer() {
+    g_calls.fetch_add(1, std::memory_order_relaxed);
+    if (g_config.callLatencyUs == 0) return;
+    auto end = std::chrono::steady_clock::now() + std::chrono::microseconds(g_config.callLatencyUs);
+    if (g_config.sleepOnCalls) {
+        std::this_thread::sleep_until(end);
+        return;
+    }
+    while (std::chrono::steady_clock::now() < end) {
+    }
+}
+
+// A handle is (gpu + 1) * 256, plus the instance index + 1 for a MIG device
+nvmlDevice_t handle(unsigned int gpu, unsigned int instance = 0) {
+    return reinterpret_cast<nvmlDevice_t>(static_cast<uintptr_t>((gpu + 1) * 256 + instance));
+}
+unsigned int gpuOf(nvmlDevice_t device) {
+    return static_cast<unsigned int>(reinterpret_cast<uintptr_t>(device) / 256) - 1;
+}
+unsigned int instanceOf(nvmlDevice_t device) {
+    return static_cast<unsigned int>(reinterpret_cast<uintptr_t>(device) % 256);
+}
+
+nvmlReturn_t readList(const std::vector<nvmlProcessInfo_t>& list, unsigned int* count, nvmlProcessInfo_t* infos) {
+    answer();
+    unsigned int size = static_cast<unsigned int>(list.size());
+    bool fits = *count >= size;
+    *count = size;
+    if (!fits) return NVML_ERROR_INSUFFICIENT_SIZE;
+    std::copy(list.begin(), list.end(), infos);
+    return NVML_SUCCESS;
+}
+
+nvmlProcessInfo_t process(unsigned int pid, unsigned long long memory, unsigned int instance) {
+    nvmlProcessInfo_t info{};
+    info.pid = pid;
+    info.usedGpuMemory = memory;
+    info.gpuInstanceId = instance + 1;  // Instance IDs as the driver numbers them
+    info.computeInstanceId = 0;
+    return info;
+}
+
+void buildProcessLists() {
+    g_computeLists.assign(g_config.gpus, {});
+    g_mpsLists.assign(g_config.gpus, {});
+    unsigned int instances = g_config.migInstances;
+    for (unsigned int gpu = 0; gpu < g_config.gpus; gpu++) {
+        for (unsigned int i = 0; i < g_config.processes; i++) {
+            unsigned int pid = FIRST_PID + gpu * g_config.processes + i;
+            unsigned long long memory = (256ull + i % 64) << 20;
+            unsigned int instance = instances ? i % instances : 0;
+            g_computeLists[gpu].push_back(process(pid, memory, instance));
+            if (instances > 1 && i % 4 == 0) {
+                g_computeLists[gpu].push_back(process(pid, memory / 2, (instance + 1) % instances));
+            }
+            if (i < g_config.mpsClients) {
+                g_mpsLists[gpu].push_back(process(pid, memory / 4, instance));
+            }
+        }
+    }
+}
+
+// Required entry points
+
+nvmlReturn_t initDriver() {
+    answer();
+    return NVML_SUCCESS;
+}
+
+nvmlReturn_t shutdownDriver() {
+    answer();
+    return NVML_SUCCESS;
+}
+
+nvmlReturn_t driverVersion(char* version, unsigned int length) {
+    answer();
+    snprintf(version, length, "999.99");
+    return NVML_SUCCESS;
+}
+
+nvmlReturn_t deviceCount(unsigned int* count) {
+    answer();
+    *count = g_config.gpus;
+    return NVML_SUCCESS;
+}
+
+nvmlReturn_t handleByIndex(unsigned int index, nvmlDevice_t* device) {
+    answer();
+    if (index >= g_config.gpus) return NVML_ERROR_INVALID_ARGUMENT;
+    *device = handle(index);
+    return NVML_SUCCESS;
+}
+
+nvmlReturn_t name(nvmlDevice_t device, char* text, unsigned int length) {
+    answer();
+    if (instanceOf(device)) {
+        snprintf(text, length, "Fake GPU MIG 1g.10gb");
+    } else {
+        snprintf(text, length, "Fake GPU %u", gpuOf(device));
+    }
+    return NVML_SUCCESS;
+}
+
+nvmlReturn_t uuid(nvmlDevice_t device, char* text, unsigned int length) {
+    answer();
+    if (instanceOf(device)) {
+        snprintf(text, length, "MIG-fake-%u-%u", gpuOf(device), instanceOf(device) - 1);
+    } else {
+        snprintf(text, length, "GPU-fake-%u", gpuOf(device));
+    }
+    return NVML_SUCCESS;
+}
+
+nvmlReturn_t pciInfo(nvmlDevice_t device, nvmlPciInfo_t* pci) {
+    answer();
+    memset(pci, 0, sizeof(*pci));
+    snprintf(pci->busId, sizeof(pci->busId), "00000000:%02X:00.0", gpuOf(device) + 1);
+    return NVML_SUCCESS;
+}
+
+nvmlReturn_t maxClock(nvmlDevice_t, nvmlClockType_t type, unsigned int* clock) {
+    answer();
+    *clock = (type == NVML_CLOCK_MEM) ? 2619 : 1980;
+    return NVML_SUCCESS;
+}
+
+nvmlReturn_t eccMode(nvmlDevice_t, nvmlEnableState_t*, nvmlEnableState_t*) {
+    answer();
+    return NVML_ERROR_NOT_SUPPORTED;
+}
+
+nvmlReturn_t persistenceMode(nvmlDevice_t, nvmlEnableState_t* mode) {
+    answer();
+    *mode = NVML_FEATURE_ENABLED;
+    return NVML_SUCCESS;
+}
+
+nvmlReturn_t memoryInfo(nvmlDevice_t device, nvmlMemory_t* memory) {
+    answer();
+    memory->total = (instanceOf(device) ? 10ull : 80ull) << 30;
+    memory->used = memory->total / 3;
+    memory->free = memory->total - memory->used;
+    return NVML_SUCCESS;
+}
+
+nvmlReturn_t utilization(nvmlDevice_t, nvmlUtilization_t* rates) {
+    answer();
+    rates->gpu = 87;
+    rates->memory = 41;
+    return NVML_SUCCESS;
+}
+
+nvmlReturn_t temperature(nvmlDevice_t, nvmlTemperatureSensors_t, unsigned int* celsius) {
+    answer();
+    *celsius = 64;
+    return NVML_SUCCESS;
+}
+
+nvmlReturn_t fanSpeed(nvmlDevice_t, unsigned int*) {
+    answer();
+    return NVML_ERROR_NOT_SUPPORTED;  // Passively cooled, like data center boards
+}
+
+nvmlReturn_t powerUsage(nvmlDevice_t, unsigned int* milliwatts) {
+    answer();
+    *milliwatts = 512000;
+    return NVML_SUCCESS;
+}
+
+nvmlReturn_t powerLimit(nvmlDevice_t, unsigned int* milliwatts) {
+    answer();
+    *milliwatts = 700000;
+    return NVML_SUCCESS;
+}
+
+nvmlReturn_t clockInfo(nvmlDevice_t, nvmlClockType_t type, unsigned int* clock) {
+    answer();
+    *clock = (type == NVML_CLOCK_MEM) ? 2619 : 1755;
+    return NVML_SUCCESS;
+}
+
+nvmlReturn_t pcieGeneration(nvmlDevice_t, unsigned int* generation) {
+    answer();
+    *generation = 5;
+    return NVML_SUCCESS;
+}
+
+nvmlReturn_t pcieWidth(nvmlDevice_t, unsigned int* width) {
+    answer();
+    *width = 16;
+    return NVML_SUCCESS;
+}
+
+nvmlReturn_t eccErrors(nvmlDevice_t, nvmlMemoryErrorType_t, nvmlEccCounterType_t, unsigned long long*) {
+    answer();
+    return NVML_ERROR_NOT_SUPPORTED;
+}
+
+// Processes
+
+nvmlReturn_t computeProcesses(nvmlDevice_t device, unsigned int* count, nvmlProcessInfo_t* infos) {
+    return readList(g_computeLists[gpuOf(device)], count, infos);
+}
+
+nvmlReturn_t graphicsProcesses(nvmlDevice_t, unsigned int* count, nvmlProcessInfo_t*) {
+    answer();
+    *count = 0;
+    return NVML_SUCCESS;
+}
+
+nvmlReturn_t mpsProcesses(nvmlDevice_t device, unsigned int* count, nvmlProcessInfo_t* infos) {
+    return readList(g_mpsLists[gpuOf(device)], count, infos);
+}
+
+// MIG
+
+nvmlReturn_t migMode(nvmlDevice_t, unsigned int* current, unsigned int* pending) {
+    answer();
+    *current = *pending = g_config.migInstances ? NVML_DEVICE_MIG_ENABLE : NVML_DEVICE_MIG_DISABLE;
+    return NVML_SUCCESS;
+}
+
+nvmlReturn_t maxMigDevices(nvmlDevice_t, unsigned int* count) {
+    answer();
+    *count = MAX_MIG_INSTANCES;
+    return NVML_SUCCESS;
+}
+
+nvmlReturn_t migHandle(nvmlDevice_t device, unsigned int index, nvmlDevice_t* mig) {
+    answer();
+    if (index >= g_config.migInstances) return NVML_ERROR_NOT_FOUND;
+    *mig = handle(gpuOf(device), index + 1);
+    return NVML_SUCCESS;
+}
+
+nvmlReturn_t gpuInstanceId(nvmlDevice_t device, unsigned int* id) {
+    answer();
+    *id = instanceOf(device);  // Matches nvmlProcessInfo_t::gpuInstanceId above
+    return NVML_SUCCESS;
+}
+
+nvmlReturn_t computeInstanceId(nvmlDevice_t, unsigned int* id) {
+    answer();
+    *id = 0;
+    return NVML_SUCCESS;
+}
+
+nvmlReturn_t attributes(nvmlDevice_t, nvmlDeviceAttributes_t* attributes) {
+    answer();
+    memset(attributes, 0, sizeof(*attributes));
+    attributes->multiprocessorCount = 16;
+    attributes->memorySizeMB = 10240;
+    return NVML_SUCCESS;
+}
+
+} // namespace
+
+const NvmlApi* fakeNvmlApi(const FakeNvmlConfig& config) {
+    static NvmlApi api;
+    g_config = config;
+    g_config.migInstances = std::min(g_config.migInstances, MAX_MIG_INSTANCES);
+    buildProcessLists();
+
+    api.nvmlInit = initDriver;
+    api.nvmlShutdown = shutdownDriver;
+    api.nvmlSystemGetDriverVersion = driverVersion;
+    api.nvmlDeviceGetCount = deviceCount;
+    api.nvmlDeviceGetHandleByIndex = handleByIndex;
+    api.nvmlDeviceGetName = name;
+    api.nvmlDeviceGetUUID = uuid;
+    api.nvmlDeviceGetPciInfo = pciInfo;
+    api.nvmlDeviceGetMaxClockInfo = maxClock;
+    api.nvmlDeviceGetEccMode = eccMode;
+    api.nvmlDeviceGetPersistenceMode = persistenceMode;
+    api.nvmlDeviceGetMemoryInfo = memoryInfo;
+    api.nvmlDeviceGetUtilizationRates = utilization;
+    api.nvmlDeviceGetTemperature = temperature;
+    api.nvmlDeviceGetFanSpeed = fanSpeed;
+    api.nvmlDeviceGetPowerUsage = powerUsage;
+    api.nvmlDeviceGetPowerManagementLimit = powerLimit;
+    api.nvmlDeviceGetClockInfo = clockInfo;
+    api.nvmlDeviceGetCurrPcieLinkGeneration = pcieGeneration;
+    api.nvmlDeviceGetCurrPcieLinkWidth = pcieWidth;
+    api.nvmlDeviceGetTotalEccErrors = eccErrors;
+
+    api.nvmlDeviceGetComputeRunningProcesses = computeProcesses;
+    api.nvmlDeviceGetGraphicsRunningProcesses = graphicsProcesses;
+    api.nvmlDeviceGetMPSComputeRunningProcesses = mpsProcesses;
+
+    api.nvmlDeviceGetMigMode = migMode;
+    api.nvmlDeviceGetMaxMigDeviceCount = maxMigDevices;
+    api.nvmlDeviceGetMigDeviceHandleByIndex = migHandle;
+    api.nvmlDeviceGetGpuInstanceId = gpuInstanceId;
+    api.nvmlDeviceGetComputeInstanceId = computeInstanceId;
+    api.nvmlDeviceGetAttributes = attributes;
+    return &api;
+}
+
+unsigned long long fakeNvmlCalls() {
+    return g_calls.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "backend/nvml_api.h"
+
+// A fake NVML driver for the benchmarks: a function table to hand to NvmlBackend in
+// place of the driver's library, so the backend's own collection code (call timing,
+// list reads, process merging) runs on machines without NVIDIA hardware. Entry points
+// beyond the required set and the process and MIG queries are left null, as on an old
+// driver.
+
+struct FakeNvmlConfig {
+    unsigned int gpus{1};
+    unsigned int processes{0};      // Compute processes per GPU
+    unsigned int migInstances{0};   // GPU instances per GPU; 0 leaves MIG disabled
+    unsigned int mpsClients{0};     // Processes per GPU also listed as MPS clients
+    unsigned int callLatencyUs{0};  // Time each call takes, like a driver round trip
+    bool sleepOnCalls{false};       // Sleep through that time, like a call blocked in the
+                                    // kernel, instead of spinning (CPU time, the default)
+};
+
+// Configure the fake and return its table. There is one fake driver per process: the
+// table stays valid for the life of the process, and a later call reconfigures it.
+const NvmlApi* fakeNvmlApi(const FakeNvmlConfig& config);
+
+// Calls the fake has answered so far
+unsigned long long fakeNvmlCalls();
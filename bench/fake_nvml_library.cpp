@@ -0,0 +1,171 @@
+// The fake NVML driver (fake_nvml.h) as a shared library, so the runtime loader in
+// src/backend/nvml_api.cpp can be pointed at it with GPU_MONITOR_NVML_LIBRARY. Every entry
+// point the fake implements is exported under the name nvml.h gives it: the header's
+// versioning macros turn the definitions below into nvmlInit_v2, nvmlDeviceGetCount_v2, ...,
+// the same symbols the loader asks dlsym / GetProcAddress for. Entry points the fake leaves
+// null are not exported, as on an old driver.
+//
+// The library takes its configuration from the environment, read on first use:
+//   FAKE_NVML_GPUS (1), FAKE_NVML_PROCESSES (0), FAKE_NVML_MIG (0), FAKE_NVML_MPS (0),
+//   FAKE_NVML_LATENCY_US (0), FAKE_NVML_SLEEP (0: calls spin through their latency)
+
+#include "fake_nvml.h"
+
+#include <cstdlib>
+
+namespace {
+
+unsigned int environmentValue(const char* name, unsigned int fallback) {
+    const char* value = std::getenv(name);
+    return value ? static_cast<unsigned int>(std::strtoul(value, nullptr, 10)) : fallback;
+}
+
+const NvmlApi& api() {
+    static const NvmlApi* table = [] {
+        FakeNvmlConfig config;
+        config.gpus = environmentValue("FAKE_NVML_GPUS", 1);
+        config.processes = environmentValue("FAKE_NVML_PROCESSES", 0);
+        config.migInstances = environmentValue("FAKE_NVML_MIG", 0);
+        config.mpsClients = environmentValue("FAKE_NVML_MPS", 0);
+        config.callLatencyUs = environmentValue("FAKE_NVML_LATENCY_US", 0);
+        config.sleepOnCalls = environmentValue("FAKE_NVML_SLEEP", 0) != 0;
+        return fakeNvmlApi(config);
+    }();
+    return *table;
+}
+
+} // namespace
+
+extern "C" {
+
+// Required entry points
+
+nvmlReturn_t DECLDIR nvmlInit(void) {
+    return api().nvmlInit();
+}
+
+nvmlReturn_t DECLDIR nvmlShutdown(void) {
+    return api().nvmlShutdown();
+}
+
+nvmlReturn_t DECLDIR nvmlSystemGetDriverVersion(char* version, unsigned int length) {
+    return api().nvmlSystemGetDriverVersion(version, length);
+}
+
+nvmlReturn_t DECLDIR nvmlDeviceGetCount(unsigned int* count) {
+    return api().nvmlDeviceGetCount(count);
+}
+
+nvmlReturn_t DECLDIR nvmlDeviceGetHandleByIndex(unsigned int index, nvmlDevice_t* device) {
+    return api().nvmlDeviceGetHandleByIndex(index, device);
+}
+
+nvmlReturn_t DECLDIR nvmlDeviceGetName(nvmlDevice_t device, char* name, unsigned int length) {
+    return api().nvmlDeviceGetName(device, name, length);
+}
+
+nvmlReturn_t DECLDIR nvmlDeviceGetUUID(nvmlDevice_t device, char* uuid, unsigned int length) {
+    return api().nvmlDeviceGetUUID(device, uuid, length);
+}
+
+nvmlReturn_t DECLDIR nvmlDeviceGetPciInfo(nvmlDevice_t device, nvmlPciInfo_t* pci) {
+    return api().nvmlDeviceGetPciInfo(device, pci);
+}
+
+nvmlReturn_t DECLDIR nvmlDeviceGetMaxClockInfo(nvmlDevice_t device, nvmlClockType_t type, unsigned int* clock) {
+    return api().nvmlDeviceGetMaxClockInfo(device, type, clock);
+}
+
+nvmlReturn_t DECLDIR nvmlDeviceGetEccMode(nvmlDevice_t device, nvmlEnableState_t* current, nvmlEnableState_t* pending) {
+    return api().nvmlDeviceGetEccMode(device, current, pending);
+}
+
+nvmlReturn_t DECLDIR nvmlDeviceGetPersistenceMode(nvmlDevice_t device, nvmlEnableState_t* mode) {
+    return api().nvmlDeviceGetPersistenceMode(device, mode);
+}
+
+nvmlReturn_t DECLDIR nvmlDeviceGetMemoryInfo(nvmlDevice_t device, nvmlMemory_t* memory) {
+    return api().nvmlDeviceGetMemoryInfo(device, memory);
+}
+
+nvmlReturn_t DECLDIR nvmlDeviceGetUtilizationRates(nvmlDevice_t device, nvmlUtilization_t* utilization) {
+    return api().nvmlDeviceGetUtilizationRates(device, utilization);
+}
+
+nvmlReturn_t DECLDIR nvmlDeviceGetTemperature(nvmlDevice_t device, nvmlTemperatureSensors_t sensor, unsigned int* temp) {
+    return api().nvmlDeviceGetTemperature(device, sensor, temp);
+}
+
+nvmlReturn_t DECLDIR nvmlDeviceGetFanSpeed(nvmlDevice_t device, unsigned int* speed) {
+    return api().nvmlDeviceGetFanSpeed(device, speed);
+}
+
+nvmlReturn_t DECLDIR nvmlDeviceGetPowerUsage(nvmlDevice_t device, unsigned int* power) {
+    return api().nvmlDeviceGetPowerUsage(device, power);
+}
+
+nvmlReturn_t DECLDIR nvmlDeviceGetPowerManagementLimit(nvmlDevice_t device, unsigned int* limit) {
+    return api().nvmlDeviceGetPowerManagementLimit(device, limit);
+}
+
+nvmlReturn_t DECLDIR nvmlDeviceGetClockInfo(nvmlDevice_t device, nvmlClockType_t type, unsigned int* clock) {
+    return api().nvmlDeviceGetClockInfo(device, type, clock);
+}
+
+nvmlReturn_t DECLDIR nvmlDeviceGetCurrPcieLinkGeneration(nvmlDevice_t device, unsigned int* generation) {
+    return api().nvmlDeviceGetCurrPcieLinkGeneration(device, generation);
+}
+
+nvmlReturn_t DECLDIR nvmlDeviceGetCurrPcieLinkWidth(nvmlDevice_t device, unsigned int* width) {
+    return api().nvmlDeviceGetCurrPcieLinkWidth(device, width);
+}
+
+nvmlReturn_t DECLDIR nvmlDeviceGetTotalEccErrors(nvmlDevice_t device, nvmlMemoryErrorType_t errorType,
+                                                 nvmlEccCounterType_t counterType, unsigned long long* count) {
+    return api().nvmlDeviceGetTotalEccErrors(device, errorType, counterType, count);
+}
+
+// Processes
+
+nvmlReturn_t DECLDIR nvmlDeviceGetComputeRunningProcesses(nvmlDevice_t device, unsigned int* count,
+                                                          nvmlProcessInfo_t* infos) {
+    return api().nvmlDeviceGetComputeRunningProcesses(device, count, infos);
+}
+
+nvmlReturn_t DECLDIR nvmlDeviceGetGraphicsRunningProcesses(nvmlDevice_t device, unsigned int* count,
+                                                           nvmlProcessInfo_t* infos) {
+    return api().nvmlDeviceGetGraphicsRunningProcesses(device, count, infos);
+}
+
+nvmlReturn_t DECLDIR nvmlDeviceGetMPSComputeRunningProcesses(nvmlDevice_t device, unsigned int* count,
+                                                             nvmlProcessInfo_t* infos) {
+    return api().nvmlDeviceGetMPSComputeRunningProcesses(device, count, infos);
+}
+
+// MIG
+
+nvmlReturn_t DECLDIR nvmlDeviceGetMigMode(nvmlDevice_t device, unsigned int* current, unsigned int* pending) {
+    return api().nvmlDeviceGetMigMode(device, current, pending);
+}
+
+nvmlReturn_t DECLDIR nvmlDeviceGetMaxMigDeviceCount(nvmlDevice_t device, unsigned int* count) {
+    return api().nvmlDeviceGetMaxMigDeviceCount(device, count);
+}
+
+nvmlReturn_t DECLDIR nvmlDeviceGetMigDeviceHandleByIndex(nvmlDevice_t device, unsigned int index, nvmlDevice_t* mig) {
+    return api().nvmlDeviceGetMigDeviceHandleByIndex(device, index, mig);
+}
+
+nvmlReturn_t DECLDIR nvmlDeviceGetGpuInstanceId(nvmlDevice_t device, unsigned int* id) {
+    return api().nvmlDeviceGetGpuInstanceId(device, id);
+}
+
+nvmlReturn_t DECLDIR nvmlDeviceGetComputeInstanceId(nvmlDevice_t device, unsigned int* id) {
+    return api().nvmlDeviceGetComputeInstanceId(device, id);
+}
+
+nvmlReturn_t DECLDIR nvmlDeviceGetAttributes(nvmlDevice_t device, nvmlDeviceAttributes_t* attributes) {
+    return api().nvmlDeviceGetAttributes(device, attributes);
+}
+
+} // extern "C"
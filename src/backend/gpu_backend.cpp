@@ -0,0 +1,41 @@
+#include "backend/gpu_backend.h"
+#include "backend/nvml_backend.h"
+#include "backend/replay_backend.h"
+#include "backend/simulated_backend.h"
+#include <cstdio>
+#include <cstring>
+
+std::unique_ptr<GpuBackend> createBackend(int argc, char** argv, std::string& error) {
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+
+        if (strncmp(arg, "--simulate=", 11) == 0) {
+            SimulatedScript script;
+            unsigned int gpus = 0, processes = 0;
+            int fields = sscanf(arg + 11, "%u,%u", &gpus, &processes);
+            if (fields < 1 || gpus == 0) {
+                error = "Expected --simulate=GPUS[,PROCESSES]";
+                return nullptr;
+            }
+            script.gpuCount = gpus;
+            script.processCount = (fields == 2) ? processes : gpus * 2;
+            return std::make_unique<SimulatedBackend>(script);
+        }
+
+        if (strncmp(arg, "--replay=", 9) == 0) {
+            if (arg[9] == '\0') {
+                error = "Expected --replay=FILE";
+                return nullptr;
+            }
+            return std::make_unique<ReplayBackend>(arg + 9);
+        }
+    }
+    return std::make_unique<NvmlBackend>();
+}
+
+std::string recordingPath(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--record=", 9) == 0) return argv[i] + 9;
+    }
+    return {};
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "gpu_monitor.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+// Event reported by a backend, tagged with the device it came from
+struct DeviceEvent {
+    std::shared_ptr<const GpuDescriptor> device;  // As returned by enumerateDevices()
+    GpuEvent event{};
+};
+
+// Data source behind GpuMonitor. GpuMonitor owns scheduling, the worker pool and the
+// published snapshot; a backend only answers "what devices exist" and "what are the
+// current values of these metric groups on device N".
+class GpuBackend {
+public:
+    virtual ~GpuBackend() = default;
+
+    virtual bool initialize() = 0;
+    virtual void shutdown() = 0;
+
+    // Short name shown in the UI (e.g. "NVML", "Simulated")
+    virtual const char* name() const = 0;
+
+    // Cheap check used every poll to detect devices appearing or disappearing
+    virtual bool getDeviceCount(unsigned int& count) = 0;
+
+    // Enumerate devices and query their static properties. The position in the returned
+    // list is the device index passed to collect() until the next enumeration.
+    virtual std::vector<std::shared_ptr<const GpuDescriptor>> enumerateDevices() = 0;
+
+    // Refresh the MetricGroup bits in `groups` for one device. Values outside those groups
+    // must be left untouched. Called concurrently for different devices.
+    // Process names may be left empty; GpuMonitor resolves them from the PID.
+    // Returns false when the device is gone (fell off the bus, was reset or replaced);
+    // GpuMonitor keeps the sample as it is, enumerates again, and enumerateDevices()
+    // must leave the device out.
+    virtual bool collect(size_t device, unsigned int groups, GpuSample& sample) = 0;
+
+    // Driver/CUDA versions and interconnect info
+    virtual void querySystemInfo(SystemInfo& info) = 0;
+
+    // Asynchronous device events. When supportsEvents() is true, GpuMonitor calls
+    // waitForEvent() in a loop from a dedicated thread, concurrently with collect() and
+    // enumerateDevices(). Returns false when nothing arrived within the timeout.
+    virtual bool supportsEvents() const { return false; }
+    virtual bool waitForEvent(unsigned int /*timeoutMs*/, DeviceEvent& /*event*/) { return false; }
+
+    // Backend calls skipped by caching (0 if the backend does not cache)
+    virtual unsigned long long callsAvoided() const { return 0; }
+
+    // Latency of every driver call made so far, per function and device (empty if the
+    // backend does not time its calls). Called from any thread, concurrently with collect().
+    virtual std::vector<CallLatency> callLatency() const { return {}; }
+};
+
+// Pick a backend from command line flags:
+//   --simulate=GPUS[,PROCESSES]   deterministic simulated devices
+//   --replay=FILE                 play back samples recorded to CSV
+// Anything else (or no flag) selects NVML. Returns nullptr and sets `error` on bad flags.
+std::unique_ptr<GpuBackend> createBackend(int argc, char** argv, std::string& error);
+
+// File given with --record=FILE, where the app writes every snapshot in the replay format
+// (see ReplayRecorder). Empty when the flag is absent.
+std::string recordingPath(int argc, char** argv);
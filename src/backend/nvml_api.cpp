@@ -0,0 +1,77 @@
+#include "backend/nvml_api.h"
+#include "platform/platform.h"
+#include <cstdlib>
+#include <mutex>
+
+// Two levels so the argument is macro-expanded first (nvmlInit -> "nvmlInit_v2")
+#define NVML_STRINGIZE_(x) #x
+#define NVML_STRINGIZE(x) NVML_STRINGIZE_(x)
+
+namespace {
+
+bool resolveApi(void* library, NvmlApi& api, std::string& error) {
+    bool complete = true;
+
+#define NVML_RESOLVE_REQUIRED(name)                                                        \
+    api.name = reinterpret_cast<decltype(api.name)>(                                       \
+        Platform::findSymbol(library, NVML_STRINGIZE(name)));                              \
+    if (!api.name) {                                                                       \
+        error = "NVML library is missing " NVML_STRINGIZE(name);                           \
+        complete = false;                                                                  \
+    }
+#define NVML_RESOLVE_OPTIONAL(name)                                                        \
+    api.name = reinterpret_cast<decltype(api.name)>(                                       \
+        Platform::findSymbol(library, NVML_STRINGIZE(name)));
+
+    NVML_REQUIRED_FUNCTIONS(NVML_RESOLVE_REQUIRED)
+    NVML_OPTIONAL_FUNCTIONS(NVML_RESOLVE_OPTIONAL)
+
+#undef NVML_RESOLVE_REQUIRED
+#undef NVML_RESOLVE_OPTIONAL
+    return complete;
+}
+
+} // namespace
+
+const char* nvmlFunctionName(NvmlFunction function) {
+    static const char* const names[] = {
+#define NVML_FUNCTION_NAME(name) #name,
+        NVML_REQUIRED_FUNCTIONS(NVML_FUNCTION_NAME)
+        NVML_OPTIONAL_FUNCTIONS(NVML_FUNCTION_NAME)
+#undef NVML_FUNCTION_NAME
+    };
+    return (function >= 0 && function < NVML_FUNCTION_COUNT) ? names[function] : "?";
+}
+
+const NvmlApi* loadNvmlApi(std::string* error) {
+    static std::mutex mutex;
+    static NvmlApi api;
+    static bool loaded = false;
+    static std::string loadError;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!loaded && loadError.empty()) {
+        std::vector<std::string> candidates;
+        if (const char* overridePath = std::getenv("GPU_MONITOR_NVML_LIBRARY")) {
+            candidates.push_back(overridePath);
+        } else {
+            candidates = Platform::nvmlLibraryCandidates();
+        }
+
+        void* library = nullptr;
+        for (const auto& path : candidates) {
+            library = Platform::openLibrary(path);
+            if (library) break;
+        }
+
+        // Not retried: a driver installed while the monitor runs needs a restart anyway
+        if (!library) {
+            loadError = "NVML library not found (is the NVIDIA driver installed?)";
+        } else if (resolveApi(library, api, loadError)) {
+            loaded = true;
+        }
+    }
+
+    if (!loaded && error) *error = loadError;
+    return loaded ? &api : nullptr;
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <nvml.h>
+#include <string>
+
+// NVML entry points, resolved at runtime from the driver's library instead of being
+// linked. Members use the nvml.h API names, so the header's versioning macros
+// (nvmlInit -> nvmlInit_v2, ...) select the same symbol a link-time build would use.
+//
+// Required functions must all resolve or loading fails. Optional functions may be null
+// on older drivers; call them through callOptional().
+#define NVML_REQUIRED_FUNCTIONS(X)              \
+    X(nvmlInit)                                 \
+    X(nvmlShutdown)                             \
+    X(nvmlSystemGetDriverVersion)               \
+    X(nvmlDeviceGetCount)                       \
+    X(nvmlDeviceGetHandleByIndex)               \
+    X(nvmlDeviceGetName)                        \
+    X(nvmlDeviceGetUUID)                        \
+    X(nvmlDeviceGetPciInfo)                     \
+    X(nvmlDeviceGetMaxClockInfo)                \
+    X(nvmlDeviceGetEccMode)                     \
+    X(nvmlDeviceGetPersistenceMode)             \
+    X(nvmlDeviceGetMemoryInfo)                  \
+    X(nvmlDeviceGetUtilizationRates)            \
+    X(nvmlDeviceGetTemperature)                 \
+    X(nvmlDeviceGetFanSpeed)                    \
+    X(nvmlDeviceGetPowerUsage)                  \
+    X(nvmlDeviceGetPowerManagementLimit)        \
+    X(nvmlDeviceGetClockInfo)                   \
+    X(nvmlDeviceGetCurrPcieLinkGeneration)      \
+    X(nvmlDeviceGetCurrPcieLinkWidth)           \
+    X(nvmlDeviceGetTotalEccErrors)
+
+#define NVML_OPTIONAL_FUNCTIONS(X)              \
+    X(nvmlSystemGetCudaDriverVersion)           \
+    X(nvmlDeviceGetDriverModel)                 \
+    X(nvmlDeviceGetComputeRunningProcesses)     \
+    X(nvmlDeviceGetGraphicsRunningProcesses)    \
+    X(nvmlDeviceGetMPSComputeRunningProcesses)  \
+    X(nvmlDeviceGetProcessUtilization)          \
+    X(nvmlDeviceGetAccountingMode)              \
+    X(nvmlDeviceGetAccountingPids)              \
+    X(nvmlDeviceGetAccountingStats)             \
+    X(nvmlDeviceGetNvLinkState)                 \
+    X(nvmlDeviceGetNvLinkRemotePciInfo)         \
+    X(nvmlDeviceGetNvLinkVersion)               \
+    X(nvmlDeviceGetTopologyCommonAncestor)      \
+    X(nvmlDeviceGetP2PStatus)                   \
+    X(nvmlDeviceGetCurrentClocksEventReasons)   \
+    X(nvmlDeviceGetCurrentClocksThrottleReasons) \
+    X(nvmlDeviceGetTotalEnergyConsumption)      \
+    X(nvmlDeviceGetPcieReplayCounter)           \
+    X(nvmlDeviceGetMigMode)                     \
+    X(nvmlDeviceGetMaxMigDeviceCount)           \
+    X(nvmlDeviceGetMigDeviceHandleByIndex)      \
+    X(nvmlDeviceGetGpuInstanceId)               \
+    X(nvmlDeviceGetComputeInstanceId)           \
+    X(nvmlDeviceGetAttributes)                  \
+    X(nvmlGpmQueryDeviceSupport)                \
+    X(nvmlGpmSampleAlloc)                       \
+    X(nvmlGpmSampleFree)                        \
+    X(nvmlGpmSampleGet)                         \
+    X(nvmlGpmMigSampleGet)                      \
+    X(nvmlGpmMetricsGet)                        \
+    X(nvmlDeviceGetFieldValues)                 \
+    X(nvmlDeviceGetSamples)                     \
+    X(nvmlEventSetCreate)                       \
+    X(nvmlEventSetFree)                         \
+    X(nvmlEventSetWait)                         \
+    X(nvmlDeviceGetSupportedEventTypes)         \
+    X(nvmlDeviceRegisterEvents)
+
+// Index of every entry point (NVML_FN_nvmlInit, ...), for per-function bookkeeping
+enum NvmlFunction {
+#define NVML_FUNCTION_ID(name) NVML_FN_##name,
+    NVML_REQUIRED_FUNCTIONS(NVML_FUNCTION_ID)
+    NVML_OPTIONAL_FUNCTIONS(NVML_FUNCTION_ID)
+#undef NVML_FUNCTION_ID
+    NVML_FUNCTION_COUNT
+};
+
+// Unversioned API name of an entry point ("nvmlInit")
+const char* nvmlFunctionName(NvmlFunction function);
+
+struct NvmlApi {
+#define NVML_API_MEMBER(name) decltype(&::name) name = nullptr;
+    NVML_REQUIRED_FUNCTIONS(NVML_API_MEMBER)
+    NVML_OPTIONAL_FUNCTIONS(NVML_API_MEMBER)
+#undef NVML_API_MEMBER
+};
+
+// Load the NVML library and resolve the function table. Tries $GPU_MONITOR_NVML_LIBRARY
+// first (e.g. a stub library for testing), then the platform's default locations.
+// The library is loaded once and stays loaded for the life of the process.
+// Returns nullptr when no driver is installed or a required symbol is missing;
+// `error` (if given) then says why.
+const NvmlApi* loadNvmlApi(std::string* error = nullptr);
+
+// Call an optional entry point; a driver that lacks it reports NVML_ERROR_FUNCTION_NOT_FOUND
+template <typename Fn, typename... Args>
+nvmlReturn_t callOptional(Fn fn, Args... args) {
+    return fn ? fn(args...) : NVML_ERROR_FUNCTION_NOT_FOUND;
+}
@@ -0,0 +1,1191 @@
+#include "backend/nvml_backend.h"
+#include "backend/nvml_api.h"
+#include <algorithm>
+#include <chrono>
+#include <ranges>
+#include <thread>
+
+namespace {
+
+// Run an optional NVML query unless it is already known to be unsupported on this
+// device. NVML_ERROR_NOT_SUPPORTED is permanent for a device, as is an entry point the
+// installed driver does not export, so both clear the bit.
+template <typename Query>
+bool queryIfSupported(unsigned int& capabilities, GpuCapability cap,
+                      std::atomic<unsigned long long>& callsAvoided, Query&& query) {
+    if (!(capabilities & cap)) {
+        callsAvoided.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    nvmlReturn_t result = query();
+    if (result == NVML_ERROR_NOT_SUPPORTED || result == NVML_ERROR_FUNCTION_NOT_FOUND) {
+        capabilities &= ~cap;
+    }
+    return result == NVML_SUCCESS;
+}
+
+// NVML_FN(name) expands to the entry point's id and function pointer, the first two
+// arguments of timedCall()
+#define NVML_FN(name) NVML_FN_##name, m_nvml->name
+
+// Call an entry point and record its latency in `table`. An entry point the driver lacks
+// is not called and not recorded. Results that are part of normal operation are not
+// counted as errors: unsupported queries, buffers that need to grow, and sample reads
+// with nothing new.
+template <typename Fn, typename... Args>
+nvmlReturn_t timedCall(NvmlCallTable& table, NvmlFunction function, Fn fn, Args... args) {
+    if (!fn) return NVML_ERROR_FUNCTION_NOT_FOUND;
+
+    auto start = std::chrono::steady_clock::now();
+    nvmlReturn_t result = fn(args...);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    NvmlCallStats& stats = table[function];
+    stats.latency.record(static_cast<unsigned long long>(
+        std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()));
+    if (result != NVML_SUCCESS && result != NVML_ERROR_NOT_SUPPORTED &&
+        result != NVML_ERROR_FUNCTION_NOT_FOUND && result != NVML_ERROR_INSUFFICIENT_SIZE &&
+        result != NVML_ERROR_NOT_FOUND) {
+        stats.errors.fetch_add(1, std::memory_order_relaxed);
+    }
+    return result;
+}
+
+// Field values and buffered samples come back as a tagged union
+double valueAsDouble(nvmlValueType_t type, const nvmlValue_t& value) {
+    switch (type) {
+        case NVML_VALUE_TYPE_DOUBLE:             return value.dVal;
+        case NVML_VALUE_TYPE_UNSIGNED_INT:       return value.uiVal;
+        case NVML_VALUE_TYPE_UNSIGNED_LONG:      return static_cast<double>(value.ulVal);
+        case NVML_VALUE_TYPE_UNSIGNED_LONG_LONG: return static_cast<double>(value.ullVal);
+        case NVML_VALUE_TYPE_SIGNED_LONG_LONG:   return static_cast<double>(value.sllVal);
+        case NVML_VALUE_TYPE_SIGNED_INT:         return value.siVal;
+        default:                                 return 0.0;
+    }
+}
+
+// Every batched field is an integer reading or counter; read them without going
+// through double so 64-bit counters keep full precision
+unsigned long long fieldAsUnsigned(const nvmlFieldValue_t& field) {
+    switch (field.valueType) {
+        case NVML_VALUE_TYPE_UNSIGNED_INT:       return field.value.uiVal;
+        case NVML_VALUE_TYPE_UNSIGNED_LONG:      return field.value.ulVal;
+        case NVML_VALUE_TYPE_UNSIGNED_LONG_LONG: return field.value.ullVal;
+        case NVML_VALUE_TYPE_SIGNED_LONG_LONG:   return static_cast<unsigned long long>(field.value.sllVal);
+        case NVML_VALUE_TYPE_SIGNED_INT:         return static_cast<unsigned long long>(field.value.siVal);
+        default:  return static_cast<unsigned long long>(valueAsDouble(field.valueType, field.value));
+    }
+}
+
+// Value at which a counter read from `field` wraps to 0, in units of `scale` (0: the full
+// 64-bit range). Some drivers report counters as 32-bit values.
+unsigned long long counterRange(const nvmlFieldValue_t& field, unsigned long long scale = 1) {
+    bool narrow = field.valueType == NVML_VALUE_TYPE_UNSIGNED_INT ||
+                  (field.valueType == NVML_VALUE_TYPE_UNSIGNED_LONG && sizeof(unsigned long) == 4);
+    return narrow ? (1ull << 32) * scale : 0;
+}
+
+// Violation-time field of each ThrottleCause (cumulative nanoseconds; 0: the driver
+// keeps no counter for the cause)
+constexpr unsigned int THROTTLE_TIME_FIELDS[THROTTLE_CAUSE_COUNT] = {
+    NVML_FI_DEV_PERF_POLICY_POWER,
+    NVML_FI_DEV_PERF_POLICY_THERMAL,
+    0,
+    NVML_FI_DEV_PERF_POLICY_BOARD_LIMIT,
+    NVML_FI_DEV_PERF_POLICY_SYNC_BOOST,
+    NVML_FI_DEV_PERF_POLICY_LOW_UTILIZATION,
+};
+
+// Polls between stats queries for an accounting PID that is running but not in the
+// process list (e.g. a process in another container)
+constexpr unsigned int ACCOUNTING_RETRY_POLLS = 30;
+
+// Accounting stats queries per device per poll; PIDs past it are queried on later polls
+constexpr unsigned int ACCOUNTING_QUERIES_PER_POLL = 16;
+
+// GPM metrics requested every poll, and where each lands in GpmMetrics
+struct GpmMetricField {
+    unsigned int metricId;
+    double GpmMetrics::*value;
+    double scale;
+};
+constexpr double MIB = 1024.0 * 1024.0;
+constexpr GpmMetricField GPM_METRIC_FIELDS[] = {
+    {NVML_GPM_METRIC_SM_UTIL,                &GpmMetrics::smActivity,          1.0},
+    {NVML_GPM_METRIC_SM_OCCUPANCY,           &GpmMetrics::smOccupancy,         1.0},
+    {NVML_GPM_METRIC_ANY_TENSOR_UTIL,        &GpmMetrics::tensorActivity,      1.0},
+    {NVML_GPM_METRIC_DRAM_BW_UTIL,           &GpmMetrics::dramBandwidth,       1.0},
+    {NVML_GPM_METRIC_PCIE_TX_PER_SEC,        &GpmMetrics::pcieTxBytesPerSec,   MIB},  // MiB/s
+    {NVML_GPM_METRIC_PCIE_RX_PER_SEC,        &GpmMetrics::pcieRxBytesPerSec,   MIB},
+    {NVML_GPM_METRIC_NVLINK_TOTAL_TX_PER_SEC, &GpmMetrics::nvlinkTxBytesPerSec, MIB},
+    {NVML_GPM_METRIC_NVLINK_TOTAL_RX_PER_SEC, &GpmMetrics::nvlinkRxBytesPerSec, MIB},
+};
+
+TopologyLevel topologyLevel(nvmlGpuTopologyLevel_t level) {
+    switch (level) {
+        case NVML_TOPOLOGY_INTERNAL:   return TOPO_SAME_BOARD;
+        case NVML_TOPOLOGY_SINGLE:     return TOPO_PCIE_SWITCH;
+        case NVML_TOPOLOGY_MULTIPLE:   return TOPO_PCIE_SWITCHES;
+        case NVML_TOPOLOGY_HOSTBRIDGE: return TOPO_HOST_BRIDGE;
+        case NVML_TOPOLOGY_NODE:       return TOPO_NUMA_NODE;
+        case NVML_TOPOLOGY_SYSTEM:     return TOPO_SYSTEM;
+        default:                       return TOPO_UNKNOWN;
+    }
+}
+
+} // namespace
+
+NvmlBackend::~NvmlBackend() {
+    shutdown();
+}
+
+bool NvmlBackend::initialize() {
+    if (m_initialized) return true;
+
+    // No driver: fail fast and let the monitor run with an empty device list
+    if (!m_nvml) m_nvml = loadNvmlApi();
+    if (!m_nvml) return false;
+
+    m_initialized = (timedCall(m_systemCalls, NVML_FN(nvmlInit)) == NVML_SUCCESS);
+
+    // Devices join the set as they are enumerated; without it the monitor just polls
+    if (m_initialized &&
+        timedCall(m_systemCalls, NVML_FN(nvmlEventSetCreate), &m_eventSet) != NVML_SUCCESS) {
+        m_eventSet = nullptr;
+    }
+    return m_initialized;
+}
+
+void NvmlBackend::shutdown() {
+    if (m_initialized) {
+        if (m_eventSet) {
+            timedCall(m_systemCalls, NVML_FN(nvmlEventSetFree), m_eventSet);
+            m_eventSet = nullptr;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_eventMutex);
+            m_eventDevices.clear();
+        }
+        releaseDevices(m_devices);  // Handles are invalid after nvmlShutdown
+        m_busIdIndex.clear();
+        timedCall(m_systemCalls, NVML_FN(nvmlShutdown));
+        m_initialized = false;
+    }
+}
+
+void NvmlBackend::releaseDevices(std::vector<Device>& devices) {
+    for (auto& state : devices) {
+        freeGpm(state.gpm, *state.calls);
+        for (auto& [id, samples] : state.migGpm) {
+            freeGpm(samples, *state.calls);
+        }
+    }
+    devices.clear();
+}
+
+void NvmlBackend::freeGpm(GpmSamples& samples, NvmlCallTable& calls) {
+    for (auto& buffer : samples.buffers) {
+        if (buffer) timedCall(calls, NVML_FN(nvmlGpmSampleFree), buffer);
+        buffer = nullptr;
+    }
+    samples.newest = -1;
+}
+
+bool NvmlBackend::gpmSupported(Device& state) {
+    nvmlGpmSupport_t support{};
+    support.version = NVML_GPM_SUPPORT_VERSION;
+    return timedCall(*state.calls, NVML_FN(nvmlGpmQueryDeviceSupport), state.handle, &support) == NVML_SUCCESS &&
+           support.isSupportedDevice;
+}
+
+void NvmlBackend::readGpm(Device& state, GpmSamples& samples, std::optional<unsigned int> gpuInstanceId,
+                          GpmMetrics& metrics) {
+    NvmlCallTable& calls = *state.calls;
+    for (auto& buffer : samples.buffers) {
+        if (!buffer && timedCall(calls, NVML_FN(nvmlGpmSampleAlloc), &buffer) != NVML_SUCCESS) {
+            buffer = nullptr;
+            metrics.valid = false;
+            return;
+        }
+    }
+
+    int next = (samples.newest == 0) ? 1 : 0;
+    nvmlReturn_t result = gpuInstanceId
+        ? timedCall(calls, NVML_FN(nvmlGpmMigSampleGet), state.handle, *gpuInstanceId, samples.buffers[next])
+        : timedCall(calls, NVML_FN(nvmlGpmSampleGet), state.handle, samples.buffers[next]);
+    // NOT_SUPPORTED does not clear the capability: CAP_GPM still set means the support
+    // query at enumeration passed, and the whole-GPU sample also fails that way on a
+    // supported GPU once MIG has been enabled since the mode was read
+    if (result == NVML_ERROR_FUNCTION_NOT_FOUND) {
+        state.capabilities &= ~CAP_GPM;
+    }
+    if (result != NVML_SUCCESS) {
+        metrics.valid = false;  // Keep the older sample; the next one is diffed against it
+        return;
+    }
+    int previous = samples.newest;
+    samples.newest = next;
+    if (previous < 0) return;  // First sample: nothing to diff against yet
+
+    nvmlGpmMetricsGet_t request{};
+    request.version = NVML_GPM_METRICS_GET_VERSION;
+    request.sample1 = samples.buffers[previous];
+    request.sample2 = samples.buffers[next];
+    request.numMetrics = static_cast<unsigned int>(std::size(GPM_METRIC_FIELDS));
+    for (size_t i = 0; i < std::size(GPM_METRIC_FIELDS); i++) {
+        request.metrics[i].metricId = GPM_METRIC_FIELDS[i].metricId;
+    }
+    if (timedCall(calls, NVML_FN(nvmlGpmMetricsGet), &request) != NVML_SUCCESS) {
+        metrics.valid = false;
+        return;
+    }
+    for (size_t i = 0; i < std::size(GPM_METRIC_FIELDS); i++) {
+        if (request.metrics[i].nvmlReturn == NVML_SUCCESS) {
+            metrics.*GPM_METRIC_FIELDS[i].value = request.metrics[i].value * GPM_METRIC_FIELDS[i].scale;
+        }
+    }
+    metrics.valid = true;
+}
+
+bool NvmlBackend::getDeviceCount(unsigned int& count) {
+    return m_initialized && timedCall(m_systemCalls, NVML_FN(nvmlDeviceGetCount), &count) == NVML_SUCCESS;
+}
+
+std::vector<std::shared_ptr<const GpuDescriptor>> NvmlBackend::enumerateDevices() {
+    // Devices found again (by UUID) keep their state; the rest are freed below
+    std::vector<Device> previous = std::move(m_devices);
+    m_devices.clear();
+    m_busIdIndex.clear();
+    std::vector<std::shared_ptr<const GpuDescriptor>> descriptors;
+    if (!m_initialized) return descriptors;
+
+    unsigned int deviceCount = 0;
+    if (timedCall(m_systemCalls, NVML_FN(nvmlDeviceGetCount), &deviceCount) != NVML_SUCCESS) {
+        releaseDevices(previous);
+        return descriptors;
+    }
+    m_devices.reserve(deviceCount);
+
+    for (unsigned int i = 0; i < deviceCount; i++) {
+        nvmlDevice_t device;
+        if (timedCall(m_systemCalls, NVML_FN(nvmlDeviceGetHandleByIndex), i, &device) != NVML_SUCCESS) continue;
+
+        auto desc = std::make_shared<GpuDescriptor>();
+        desc->cudaIndex = i;  // NVML index matches CUDA index
+
+        // UUID (unique identifier for this specific GPU). A device that cannot report it
+        // is lost or mid-reset and is left out until it can. Every later call is timed
+        // against the device it identifies.
+        char uuid[NVML_DEVICE_UUID_BUFFER_SIZE];
+        if (timedCall(m_systemCalls, NVML_FN(nvmlDeviceGetUUID), device, uuid, sizeof(uuid)) != NVML_SUCCESS) {
+            continue;
+        }
+        desc->uuid = uuid;
+        NvmlCallTable& calls = callTable(desc->uuid);
+
+        // Name
+        char name[NVML_DEVICE_NAME_BUFFER_SIZE];
+        if (timedCall(calls, NVML_FN(nvmlDeviceGetName), device, name, sizeof(name)) == NVML_SUCCESS) {
+            desc->name = name;
+        }
+
+        // PCI Bus ID (physical slot location)
+        nvmlPciInfo_t pci;
+        if (timedCall(calls, NVML_FN(nvmlDeviceGetPciInfo), device, &pci) == NVML_SUCCESS) {
+            desc->pciBusId = pci.busId;
+        }
+
+        // Driver model (TCC vs WDDM) - Windows only
+        // NVML_DRIVER_WDDM = 0 (display), NVML_DRIVER_WDM = 1 (TCC/compute)
+        nvmlDriverModel_t current, pending;
+        if (timedCall(calls, NVML_FN(nvmlDeviceGetDriverModel), device, &current, &pending) == NVML_SUCCESS) {
+            desc->isTCC = (current == NVML_DRIVER_WDM);
+        }
+
+        // Max clocks
+        unsigned int clock;
+        if (timedCall(calls, NVML_FN(nvmlDeviceGetMaxClockInfo), device, NVML_CLOCK_GRAPHICS, &clock) == NVML_SUCCESS) {
+            desc->gpuClockMax = clock;
+        }
+        if (timedCall(calls, NVML_FN(nvmlDeviceGetMaxClockInfo), device, NVML_CLOCK_MEM, &clock) == NVML_SUCCESS) {
+            desc->memClockMax = clock;
+        }
+
+        // ECC mode
+        nvmlEnableState_t eccMode;
+        if (timedCall(calls, NVML_FN(nvmlDeviceGetEccMode), device, &eccMode, nullptr) == NVML_SUCCESS) {
+            desc->eccSupported = true;
+            desc->eccEnabled = (eccMode == NVML_FEATURE_ENABLED);
+        }
+
+        // NVLink link count (also bounds the per-link counter fields below). Drivers without
+        // the count field are probed link by link: links are numbered from 0, and the first
+        // link the driver does not accept ends them.
+        nvmlFieldValue_t linkCount{};
+        linkCount.fieldId = NVML_FI_DEV_NVLINK_LINK_COUNT;
+        if (timedCall(calls, NVML_FN(nvmlDeviceGetFieldValues), device, 1, &linkCount) == NVML_SUCCESS &&
+            linkCount.nvmlReturn == NVML_SUCCESS) {
+            desc->nvlinkLinks = static_cast<unsigned int>(
+                std::min<unsigned long long>(fieldAsUnsigned(linkCount), NVML_NVLINK_MAX_LINKS));
+        } else {
+            nvmlEnableState_t isActive;
+            while (desc->nvlinkLinks < NVML_NVLINK_MAX_LINKS &&
+                   timedCall(calls, NVML_FN(nvmlDeviceGetNvLinkState), device, desc->nvlinkLinks,
+                             &isActive) == NVML_SUCCESS) {
+                desc->nvlinkLinks++;
+            }
+        }
+
+        // A device seen before keeps what was learned about it: unsupported queries and
+        // fields, sample cursors, list buffers and GPM samples. Only the handle is renewed.
+        Device state;
+        auto known = std::ranges::find(previous, desc->uuid,
+                                       [](const Device& entry) { return entry.descriptor->uuid; });
+        bool isNew = (known == previous.end());
+        if (!isNew) {
+            state = std::move(*known);
+            previous.erase(known);
+        }
+        state.handle = device;
+        state.calls = &calls;
+
+        if (isNew) {
+            // Batched fields per metric group
+            auto& activity = state.fields[METRIC_UTILIZATION];
+            activity.push_back({NVML_FI_DEV_POWER_INSTANT, 0});
+            activity.push_back({NVML_FI_DEV_TOTAL_ENERGY_CONSUMPTION, 0});
+            activity.push_back({NVML_FI_DEV_PCIE_COUNT_TX_BYTES, 0});
+            activity.push_back({NVML_FI_DEV_PCIE_COUNT_RX_BYTES, 0});
+            for (unsigned int link = 0; link < desc->nvlinkLinks; link++) {
+                activity.push_back({NVML_FI_DEV_NVLINK_THROUGHPUT_DATA_TX, link});
+                activity.push_back({NVML_FI_DEV_NVLINK_THROUGHPUT_DATA_RX, link});
+            }
+            auto& thermal = state.fields[METRIC_THERMAL];
+            thermal.push_back({NVML_FI_DEV_MEMORY_TEMP, 0});
+            for (unsigned int fieldId : THROTTLE_TIME_FIELDS) {
+                if (fieldId != 0) thermal.push_back({fieldId, 0});
+            }
+            state.processBuffer.resize(32);  // Grows on NVML_ERROR_INSUFFICIENT_SIZE
+
+            // GPU Performance Monitoring (Hopper and later), settled once per device: the
+            // capability bit caches the answer. Sample buffers are allocated on the first read.
+            if (!gpmSupported(state)) {
+                state.capabilities &= ~CAP_GPM;
+            }
+
+            auto& health = state.fields[METRIC_HEALTH];
+            health.push_back({NVML_FI_DEV_PCIE_REPLAY_COUNTER, 0});
+            if (desc->eccEnabled) {
+                health.push_back({NVML_FI_DEV_ECC_SBE_VOL_TOTAL, 0});
+            }
+        }
+
+        // Accounting mode is also re-read with the health group, as it can be toggled live
+        nvmlEnableState_t accounting;
+        if (timedCall(calls, NVML_FN(nvmlDeviceGetAccountingMode), device, &accounting) == NVML_SUCCESS) {
+            state.accountingEnabled = (accounting == NVML_FEATURE_ENABLED);
+        }
+
+        // Asynchronous events. Registering a handle again after re-enumeration is harmless.
+        unsigned long long eventTypes = 0;
+        if (m_eventSet &&
+            timedCall(calls, NVML_FN(nvmlDeviceGetSupportedEventTypes), device, &eventTypes) == NVML_SUCCESS) {
+            eventTypes &= nvmlEventTypeXidCriticalError | nvmlEventTypeSingleBitEccError |
+                          nvmlEventTypeDoubleBitEccError | nvmlEventTypeClock | nvmlEventTypePState;
+            if (eventTypes) {
+                timedCall(calls, NVML_FN(nvmlDeviceRegisterEvents), device, eventTypes, m_eventSet);
+            }
+        }
+
+        state.descriptor = std::move(desc);
+        descriptors.push_back(state.descriptor);
+        m_busIdIndex[state.descriptor->pciBusId] = m_devices.size();
+        m_devices.push_back(std::move(state));
+    }
+    releaseDevices(previous);  // Gone, or lost and left out until they answer again
+
+    std::lock_guard<std::mutex> lock(m_eventMutex);
+    m_eventDevices.clear();
+    for (const auto& state : m_devices) {
+        m_eventDevices.emplace_back(state.handle, state.descriptor);
+    }
+    return descriptors;
+}
+
+bool NvmlBackend::waitForEvent(unsigned int timeoutMs, DeviceEvent& event) {
+    if (!m_eventSet) return false;
+
+    // NVML_ERROR_TIMEOUT is the normal "nothing happened" result. Other errors return
+    // immediately, so wait out the timeout to keep the caller's loop from spinning.
+    nvmlEventData_t data{};
+    // Not timed: it blocks for the timeout by design
+    nvmlReturn_t result = callOptional(m_nvml->nvmlEventSetWait, m_eventSet, &data, timeoutMs);
+    if (result != NVML_SUCCESS) {
+        if (result != NVML_ERROR_TIMEOUT) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(timeoutMs));
+        }
+        return false;
+    }
+
+    event.event.timestampUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    event.event.data = 0;
+    if (data.eventType & nvmlEventTypeXidCriticalError) {
+        event.event.type = EVENT_XID;
+        event.event.data = data.eventData;
+    } else if (data.eventType & nvmlEventTypeDoubleBitEccError) {
+        event.event.type = EVENT_ECC_DOUBLE_BIT;
+    } else if (data.eventType & nvmlEventTypeSingleBitEccError) {
+        event.event.type = EVENT_ECC_SINGLE_BIT;
+    } else {
+        event.event.type = EVENT_CLOCK_CHANGE;  // Clock or P-state
+    }
+
+    std::lock_guard<std::mutex> lock(m_eventMutex);
+    auto it = std::ranges::find(m_eventDevices, data.device, [](const auto& entry) { return entry.first; });
+    event.device = (it != m_eventDevices.end()) ? it->second : nullptr;
+    return event.device != nullptr;
+}
+
+bool NvmlBackend::collect(size_t index, unsigned int groups, GpuSample& sample) {
+    Device& state = m_devices[index];
+    nvmlDevice_t device = state.handle;
+    NvmlCallTable& calls = *state.calls;
+    m_callsAvoided.fetch_add(1, std::memory_order_relaxed);  // cached handle
+
+    // Skips queries this device has reported as unsupported
+    auto query = [&](GpuCapability cap, auto&& fn) {
+        return queryIfSupported(state.capabilities, cap, m_callsAvoided, fn);
+    };
+
+    // List queries report NVML_ERROR_INSUFFICIENT_SIZE along with the count they need.
+    // `call` reads into `buffer` (size passed in and returned through `count`); the buffer
+    // is grown and the read retried, since the list can also grow between the two calls.
+    auto readList = [&](GpuCapability cap, auto& buffer, unsigned int& count, auto&& call) {
+        nvmlReturn_t result = NVML_SUCCESS;
+        for (int attempt = 0; attempt < 3; attempt++) {
+            count = static_cast<unsigned int>(buffer.size());
+            if (query(cap, [&] { return result = call(); })) return true;
+            if (result != NVML_ERROR_INSUFFICIENT_SIZE) break;
+            buffer.resize(count + count / 4 + 8);  // Headroom for entries added meanwhile
+        }
+        count = 0;
+        return false;
+    };
+
+    // Read every batched field of a group with a single nvmlDeviceGetFieldValues call.
+    // Empty result means the batch path is unavailable and individual queries are used.
+    std::vector<nvmlFieldValue_t> values;
+    auto fetchFields = [&](MetricGroup group) {
+        values.clear();
+        sample.fieldTimestampUs[group] = 0;
+        auto& requests = state.fields[group];
+        if (requests.empty()) return;
+
+        values.resize(requests.size());
+        for (size_t i = 0; i < requests.size(); i++) {
+            values[i] = nvmlFieldValue_t{};
+            values[i].fieldId = requests[i].fieldId;
+            values[i].scopeId = requests[i].scopeId;
+        }
+        if (!query(CAP_FIELD_VALUES, [&] {
+                return timedCall(calls, NVML_FN(nvmlDeviceGetFieldValues), device,
+                                    static_cast<int>(values.size()), values.data());
+            })) {
+            values.clear();
+            return;
+        }
+
+        // Unsupported fields are not requested again
+        std::vector<FieldRequest> supported;
+        long long newest = 0;
+        for (size_t i = 0; i < values.size(); i++) {
+            if (values[i].nvmlReturn == NVML_ERROR_NOT_SUPPORTED) continue;
+            supported.push_back(requests[i]);
+            if (values[i].nvmlReturn == NVML_SUCCESS) {
+                newest = std::max(newest, values[i].timestamp);
+            }
+        }
+        requests = std::move(supported);
+        sample.fieldTimestampUs[group] = newest;
+    };
+    auto field = [&](unsigned int fieldId, unsigned int scopeId = 0) -> const nvmlFieldValue_t* {
+        for (const auto& value : values) {
+            if (value.fieldId == fieldId && value.scopeId == scopeId) {
+                return value.nvmlReturn == NVML_SUCCESS ? &value : nullptr;
+            }
+        }
+        return nullptr;
+    };
+
+    // Append every buffered driver sample newer than the cursor to the trace. The first
+    // read of a buffer returns whatever the driver still holds (up to a few seconds).
+    std::vector<nvmlSample_t> buffer;
+    auto readTrace = [&](SampleTrace trace, GpuCapability cap, nvmlSamplingType_t type,
+                         double scale) {
+        auto& out = sample.traces[trace];
+        out.clear();
+
+        nvmlValueType_t valueType;
+        unsigned int& capacity = state.sampleCapacity[trace];
+        if (capacity == 0) {
+            if (!query(cap, [&] {
+                    return timedCall(calls, NVML_FN(nvmlDeviceGetSamples), device, type, 0ull,
+                                        &valueType, &capacity, nullptr);
+                })) {
+                capacity = 0;
+                return;
+            }
+        }
+
+        buffer.resize(capacity);
+        unsigned int count = capacity;
+        nvmlReturn_t result = NVML_SUCCESS;
+        if (!query(cap, [&] {
+                result = timedCall(calls, NVML_FN(nvmlDeviceGetSamples), device, type,
+                                      state.sampleCursor[trace], &valueType, &count, buffer.data());
+                return result;
+            })) {
+            // NVML_ERROR_NOT_FOUND just means nothing new since the cursor
+            if (result == NVML_ERROR_INSUFFICIENT_SIZE) capacity = 0;  // Re-size next time
+            return;
+        }
+
+        out.reserve(count);
+        for (unsigned int i = 0; i < count; i++) {
+            const nvmlSample_t& entry = buffer[i];
+            if (entry.timeStamp <= state.sampleCursor[trace]) continue;
+            TimedValue value;
+            value.timestampUs = static_cast<long long>(entry.timeStamp);
+            value.value = static_cast<float>(valueAsDouble(valueType, entry.sampleValue) * scale);
+            out.push_back(value);
+        }
+        std::ranges::sort(out, {}, &TimedValue::timestampUs);
+        if (!out.empty()) {
+            state.sampleCursor[trace] = static_cast<unsigned long long>(out.back().timestampUs);
+        }
+    };
+
+    // A reset can leave the handle pointing at a different GPU (or none); the UUID tells.
+    // Checked with the health group (also forced after XID and ECC events), before anything
+    // of another GPU is written into this one's sample.
+    if (groups & (1u << METRIC_HEALTH)) {
+        char uuid[NVML_DEVICE_UUID_BUFFER_SIZE];
+        nvmlReturn_t uuidResult = timedCall(calls, NVML_FN(nvmlDeviceGetUUID), device, uuid, sizeof(uuid));
+        if (uuidResult == NVML_ERROR_GPU_IS_LOST ||
+            (uuidResult == NVML_SUCCESS && state.descriptor->uuid != uuid)) {
+            return false;
+        }
+    }
+
+    // MIG layout. Instances only change when an administrator reconfigures the GPU, so
+    // they are re-read with the health group; usage is read with the processes group.
+    // Read ahead of the utilization group, whose GPM sampling depends on the MIG mode.
+    if (groups & (1u << METRIC_HEALTH)) {
+        unsigned int currentMode = NVML_DEVICE_MIG_DISABLE, pendingMode;
+        sample.migEnabled = query(CAP_MIG, [&] {
+                return timedCall(calls, NVML_FN(nvmlDeviceGetMigMode), device, &currentMode, &pendingMode);
+            }) && currentMode == NVML_DEVICE_MIG_ENABLE;
+
+        std::vector<MigInstance> instances;
+        state.migHandles.clear();
+        unsigned int maxCount = 0;
+        if (sample.migEnabled &&
+            timedCall(calls, NVML_FN(nvmlDeviceGetMaxMigDeviceCount), device, &maxCount) == NVML_SUCCESS) {
+            for (unsigned int i = 0; i < maxCount; i++) {
+                // Indices without an instance report NVML_ERROR_NOT_FOUND
+                nvmlDevice_t mig;
+                char text[NVML_DEVICE_UUID_V2_BUFFER_SIZE];
+                if (timedCall(calls, NVML_FN(nvmlDeviceGetMigDeviceHandleByIndex), device, i, &mig) != NVML_SUCCESS ||
+                    timedCall(calls, NVML_FN(nvmlDeviceGetUUID), mig, text, sizeof(text)) != NVML_SUCCESS) {
+                    continue;
+                }
+                MigInstance instance{};
+                instance.uuid = text;
+                instance.index = i;
+                if (timedCall(calls, NVML_FN(nvmlDeviceGetName), mig, text, sizeof(text)) == NVML_SUCCESS) {
+                    instance.name = text;
+                }
+                timedCall(calls, NVML_FN(nvmlDeviceGetGpuInstanceId), mig, &instance.gpuInstanceId);
+                timedCall(calls, NVML_FN(nvmlDeviceGetComputeInstanceId), mig, &instance.computeInstanceId);
+                nvmlDeviceAttributes_t attributes;
+                if (timedCall(calls, NVML_FN(nvmlDeviceGetAttributes), mig, &attributes) == NVML_SUCCESS) {
+                    instance.smCount = attributes.multiprocessorCount;
+                    instance.vramTotal = attributes.memorySizeMB * 1024 * 1024;
+                }
+
+                // An instance that is still there keeps its usage until the next read
+                auto previous = std::ranges::find(sample.migInstances, instance.uuid, &MigInstance::uuid);
+                if (previous != sample.migInstances.end()) {
+                    instance.vramUsed = previous->vramUsed;
+                    instance.processes = std::move(previous->processes);
+                    instance.gpm = previous->gpm;
+                }
+                instances.push_back(std::move(instance));
+                state.migHandles.push_back(mig);
+            }
+        }
+        sample.migInstances = std::move(instances);
+
+        // GPM samples of GPU instances that no longer exist
+        for (auto it = state.migGpm.begin(); it != state.migGpm.end();) {
+            auto instance = std::ranges::find(sample.migInstances, it->first, &MigInstance::gpuInstanceId);
+            if (instance == sample.migInstances.end()) {
+                freeGpm(it->second, calls);
+                it = state.migGpm.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    if (groups & (1u << METRIC_UTILIZATION)) {
+        fetchFields(METRIC_UTILIZATION);
+
+        // Sub-poll traces from the driver's sample buffers
+        readTrace(TRACE_GPU_UTILIZATION, CAP_GPU_UTIL_SAMPLES, NVML_GPU_UTILIZATION_SAMPLES, 1.0);
+        readTrace(TRACE_MEM_UTILIZATION, CAP_MEM_UTIL_SAMPLES, NVML_MEMORY_UTILIZATION_SAMPLES, 1.0);
+        readTrace(TRACE_POWER, CAP_POWER_SAMPLES, NVML_TOTAL_POWER_SAMPLES, 0.001);  // mW to W
+
+        // Utilization. Queried on every fast poll, so it is also where a GPU that fell
+        // off the bus shows up first.
+        nvmlUtilization_t utilization;
+        nvmlReturn_t utilResult = NVML_SUCCESS;
+        if (query(CAP_UTILIZATION, [&] {
+                return utilResult = timedCall(calls, NVML_FN(nvmlDeviceGetUtilizationRates), device, &utilization);
+            })) {
+            sample.gpuUtilization = utilization.gpu;
+            sample.memUtilization = utilization.memory;
+        }
+        if (utilResult == NVML_ERROR_GPU_IS_LOST) return false;
+
+        // Power (batched value is instantaneous; the query is a ~1 s average on newer GPUs)
+        unsigned int power;
+        if (auto* value = field(NVML_FI_DEV_POWER_INSTANT)) {
+            sample.powerDrawMw = static_cast<unsigned int>(fieldAsUnsigned(*value));
+        } else if (query(CAP_POWER_USAGE, [&] { return timedCall(calls, NVML_FN(nvmlDeviceGetPowerUsage), device, &power); })) {
+            sample.powerDrawMw = power;
+        }
+        sample.powerDraw = sample.powerDrawMw / 1000;  // mW to W
+
+        // Energy counter (Volta and later), the exact basis for energy over any interval
+        unsigned long long energy;
+        if (auto* value = field(NVML_FI_DEV_TOTAL_ENERGY_CONSUMPTION)) {
+            sample.energyMj = fieldAsUnsigned(*value);
+        } else if (query(CAP_ENERGY, [&] { return timedCall(calls, NVML_FN(nvmlDeviceGetTotalEnergyConsumption), device, &energy); })) {
+            sample.energyMj = energy;
+        }
+
+        // PCIe and NVLink traffic counters (batch only: the individual queries, such as
+        // nvmlDeviceGetPcieThroughput, report a rate over a short window, not a counter)
+        if (auto* value = field(NVML_FI_DEV_PCIE_COUNT_TX_BYTES)) {
+            sample.pcieTxBytes = fieldAsUnsigned(*value);
+            sample.pcieCounterRange = counterRange(*value);
+        }
+        if (auto* value = field(NVML_FI_DEV_PCIE_COUNT_RX_BYTES)) {
+            sample.pcieRxBytes = fieldAsUnsigned(*value);
+        }
+        // A link whose field is missing from one read keeps its previous value, so the
+        // totals never step backwards
+        unsigned long long nvlinkTx = 0, nvlinkRx = 0;
+        sample.nvlinkLinkBytes.resize(state.descriptor->nvlinkLinks);
+        for (unsigned int link = 0; link < state.descriptor->nvlinkLinks; link++) {
+            LinkTraffic& traffic = sample.nvlinkLinkBytes[link];
+            if (auto* value = field(NVML_FI_DEV_NVLINK_THROUGHPUT_DATA_TX, link)) {
+                traffic.txBytes = fieldAsUnsigned(*value) * 1024;  // KiB to bytes
+                sample.nvlinkCounterRange = counterRange(*value, 1024);
+            }
+            if (auto* value = field(NVML_FI_DEV_NVLINK_THROUGHPUT_DATA_RX, link)) {
+                traffic.rxBytes = fieldAsUnsigned(*value) * 1024;
+            }
+            nvlinkTx += traffic.txBytes;
+            nvlinkRx += traffic.rxBytes;
+        }
+        sample.nvlinkTxBytes = nvlinkTx;
+        sample.nvlinkRxBytes = nvlinkRx;
+
+        // Profiling metrics over the interval since the previous poll. With MIG enabled
+        // the GPU is sampled per GPU instance (from the last layout read); instances that
+        // share one are sampled once.
+        sample.gpm.valid = false;
+        if (!(state.capabilities & CAP_GPM)) {
+            m_callsAvoided.fetch_add(1, std::memory_order_relaxed);
+        } else if (!sample.migEnabled) {
+            readGpm(state, state.gpm, std::nullopt, sample.gpm);
+        } else {
+            state.gpm.newest = -1;  // Start a fresh pair if MIG is turned off again
+            for (size_t i = 0; i < sample.migInstances.size(); i++) {
+                MigInstance& instance = sample.migInstances[i];
+                auto shared = std::ranges::find(sample.migInstances.begin(), sample.migInstances.begin() + i,
+                                                instance.gpuInstanceId, &MigInstance::gpuInstanceId);
+                if (shared != sample.migInstances.begin() + i) {
+                    instance.gpm = shared->gpm;
+                } else {
+                    readGpm(state, state.migGpm[instance.gpuInstanceId], instance.gpuInstanceId, instance.gpm);
+                }
+            }
+        }
+    }
+
+    if (groups & (1u << METRIC_THERMAL)) {
+        fetchFields(METRIC_THERMAL);
+
+        // Memory temperature (HBM boards report it through the field API only)
+        if (auto* value = field(NVML_FI_DEV_MEMORY_TEMP)) {
+            sample.memTemperature = static_cast<unsigned int>(fieldAsUnsigned(*value));
+        }
+
+        readTrace(TRACE_GPU_CLOCK, CAP_GPU_CLOCK_SAMPLES, NVML_PROCESSOR_CLK_SAMPLES, 1.0);
+        readTrace(TRACE_MEM_CLOCK, CAP_MEM_CLOCK_SAMPLES, NVML_MEMORY_CLK_SAMPLES, 1.0);
+
+        // GPU temperature and current clocks have no field ID and are always queried
+        unsigned int temp;
+        if (query(CAP_TEMPERATURE, [&] { return timedCall(calls, NVML_FN(nvmlDeviceGetTemperature), device, NVML_TEMPERATURE_GPU, &temp); })) {
+            sample.temperature = temp;
+        }
+
+        // Fan speed (may not be available on all GPUs)
+        unsigned int fan;
+        if (query(CAP_FAN_SPEED, [&] { return timedCall(calls, NVML_FN(nvmlDeviceGetFanSpeed), device, &fan); })) {
+            sample.fanSpeed = fan;
+        }
+
+        // Clocks (current; max is static)
+        unsigned int clock;
+        if (query(CAP_GPU_CLOCK, [&] { return timedCall(calls, NVML_FN(nvmlDeviceGetClockInfo), device, NVML_CLOCK_GRAPHICS, &clock); })) {
+            sample.gpuClock = clock;
+        }
+        if (query(CAP_MEM_CLOCK, [&] { return timedCall(calls, NVML_FN(nvmlDeviceGetClockInfo), device, NVML_CLOCK_MEM, &clock); })) {
+            sample.memClock = clock;
+        }
+
+        // Why the clock is where it is, and how long each cause has held it back so far.
+        // Drivers since R535 call these clock event reasons and deprecate the throttle
+        // reasons query, which older drivers only have.
+        unsigned long long reasons;
+        if (query(CAP_CLOCK_REASONS, [&] {
+                nvmlReturn_t result = timedCall(calls, NVML_FN(nvmlDeviceGetCurrentClocksEventReasons), device, &reasons);
+                if (result != NVML_ERROR_FUNCTION_NOT_FOUND) return result;
+                return timedCall(calls, NVML_FN(nvmlDeviceGetCurrentClocksThrottleReasons), device, &reasons);
+            })) {
+            sample.clockEventReasons = reasons;
+        }
+        for (size_t cause = 0; cause < THROTTLE_CAUSE_COUNT; cause++) {
+            if (THROTTLE_TIME_FIELDS[cause] == 0) continue;
+            if (auto* value = field(THROTTLE_TIME_FIELDS[cause])) {
+                sample.throttleTimeNs[cause] = fieldAsUnsigned(*value);
+            }
+        }
+    }
+
+    if (groups & (1u << METRIC_PROCESSES)) {
+        // Memory
+        nvmlMemory_t memory;
+        if (query(CAP_MEMORY, [&] { return timedCall(calls, NVML_FN(nvmlDeviceGetMemoryInfo), device, &memory); })) {
+            sample.vramUsed = memory.used;
+            sample.vramTotal = memory.total;
+        }
+
+        // Running processes: compute, graphics (WDDM) and MPS clients merged into one
+        // entry per PID. A PID can appear in several lists, and several times in one list
+        // on MIG (once per instance): instance entries add up, lists overlap.
+        std::swap(sample.processes, state.previousProcesses);
+        sample.processes.clear();
+        state.processSlots.reset();
+        state.migProcessSlots.reset();
+        for (auto& instance : sample.migInstances) {
+            instance.processes.clear();
+        }
+        auto mergeProcesses = [&](unsigned int list, GpuCapability cap, NvmlFunction function, auto fn) {
+            unsigned int count = 0;
+            auto& buffer = state.processBuffer;
+            if (!readList(cap, buffer, count, [&] {
+                    return timedCall(calls, function, fn, device, &count, buffer.data());
+                })) {
+                return;
+            }
+
+            for (unsigned int p = 0; p < count; p++) {
+                const nvmlProcessInfo_t& info = buffer[p];
+                auto [slot, inserted] = state.processSlots.tryEmplace(
+                    info.pid, ProcessSlot{sample.processes.size(), list, 0, 0});
+                if (inserted) {
+                    GpuProcess proc;
+                    proc.pid = info.pid;
+                    proc.usedMemory = 0;
+                    sample.processes.push_back(std::move(proc));
+                }
+
+                if (slot->list != list) {
+                    slot->list = list;
+                    slot->listMemory = 0;
+                }
+                // Memory is not available without privileges on some configurations
+                if (info.usedGpuMemory != static_cast<unsigned long long>(NVML_VALUE_NOT_AVAILABLE)) {
+                    slot->listMemory += info.usedGpuMemory;
+                }
+                auto& proc = sample.processes[slot->index];
+                proc.usedMemory = std::max(proc.usedMemory, slot->listMemory);
+
+                // On MIG, each entry also names the instance it runs on
+                auto instance = std::ranges::find_if(sample.migInstances, [&](const MigInstance& mig) {
+                    return mig.gpuInstanceId == info.gpuInstanceId && mig.computeInstanceId == info.computeInstanceId;
+                });
+                if (instance != sample.migInstances.end()) {
+                    unsigned long long memory = info.usedGpuMemory != static_cast<unsigned long long>(NVML_VALUE_NOT_AVAILABLE)
+                        ? info.usedGpuMemory : 0;
+                    unsigned long long key =
+                        (static_cast<unsigned long long>(instance - sample.migInstances.begin()) << 32) | info.pid;
+                    auto [entry, added] = state.migProcessSlots.tryEmplace(key, instance->processes.size());
+                    if (added) {
+                        instance->processes.push_back({info.pid, memory});
+                    } else {
+                        auto& proc = instance->processes[*entry];
+                        proc.usedMemory = std::max(proc.usedMemory, memory);
+                    }
+                }
+            }
+        };
+        mergeProcesses(0, CAP_COMPUTE_PROCESSES, NVML_FN(nvmlDeviceGetComputeRunningProcesses));
+        mergeProcesses(1, CAP_GRAPHICS_PROCESSES, NVML_FN(nvmlDeviceGetGraphicsRunningProcesses));
+        mergeProcesses(2, CAP_MPS_PROCESSES, NVML_FN(nvmlDeviceGetMPSComputeRunningProcesses));
+
+        // Processes still running keep the details resolved for them on an earlier poll,
+        // so only new PIDs go to the process resolver
+        for (auto& previous : state.previousProcesses) {
+            ProcessSlot* slot = state.processSlots.find(previous.pid);
+            if (!slot) continue;
+            auto& proc = sample.processes[slot->index];
+            proc.name = std::move(previous.name);
+            proc.commandLine = std::move(previous.commandLine);
+            proc.user = std::move(previous.user);
+        }
+
+        // MIG instance memory (the parent reports the whole GPU)
+        for (size_t i = 0; i < sample.migInstances.size(); i++) {
+            if (timedCall(calls, NVML_FN(nvmlDeviceGetMemoryInfo), state.migHandles[i], &memory) == NVML_SUCCESS) {
+                sample.migInstances[i].vramUsed = memory.used;
+                sample.migInstances[i].vramTotal = memory.total;
+            }
+        }
+
+        // Per-process utilization, averaged over the driver samples taken since the last
+        // read. A process without samples was idle for the whole interval.
+        unsigned int count = 0;
+        auto& utilBuffer = state.processUtilBuffer;
+        if (!sample.processes.empty() &&
+            readList(CAP_PROCESS_UTILIZATION, utilBuffer, count, [&] {
+                return timedCall(calls, NVML_FN(nvmlDeviceGetProcessUtilization), device,
+                                    utilBuffer.data(), &count, state.processUtilCursor);
+            })) {
+            unsigned long long newest = state.processUtilCursor;
+            for (unsigned int i = 0; i < count; i++) {
+                const nvmlProcessUtilizationSample_t& util = utilBuffer[i];
+                ProcessSlot* slot = state.processSlots.find(util.pid);
+                if (util.timeStamp <= state.processUtilCursor || !slot) continue;
+                newest = std::max(newest, util.timeStamp);
+
+                auto& proc = sample.processes[slot->index];
+                proc.smUtil += util.smUtil;
+                proc.memUtil += util.memUtil;
+                proc.encUtil += util.encUtil;
+                proc.decUtil += util.decUtil;
+                slot->utilSamples++;
+            }
+            state.processSlots.forEach([&](unsigned int, const ProcessSlot& slot) {
+                if (slot.utilSamples <= 1) return;
+                auto& proc = sample.processes[slot.index];
+                proc.smUtil /= slot.utilSamples;
+                proc.memUtil /= slot.utilSamples;
+                proc.encUtil /= slot.utilSamples;
+                proc.decUtil /= slot.utilSamples;
+            });
+            state.processUtilCursor = newest;
+        }
+
+        // Exited processes from the accounting buffer. PIDs in the buffer when it is first
+        // read are history from before this session and are only recorded. After that a
+        // PID is queried when it gets a new record (a new PID, or a reused one the buffer
+        // now lists more often), and rechecked every ACCOUNTING_RETRY_POLLS polls while it
+        // runs outside the process list (e.g. in another container); unreadable records are
+        // not queried again. At most ACCOUNTING_QUERIES_PER_POLL stats queries are made per
+        // poll, so a burst of exits is spread over several polls.
+        unsigned int pidCount = 0;
+        auto& pids = state.accountingPids;
+        if (state.accountingEnabled &&
+            readList(CAP_ACCOUNTING, pids, pidCount, [&] {
+                return timedCall(calls, NVML_FN(nvmlDeviceGetAccountingPids), device, &pidCount, pids.data());
+            })) {
+            unsigned int poll = ++state.accountingPoll;
+            bool seeding = (poll == 1);
+            for (unsigned int i = 0; i < pidCount; i++) {
+                if (state.processSlots.find(pids[i])) continue;
+                auto& known = state.accountingKnown[pids[i]];
+                if (known.lastSeen != poll) {
+                    known.lastSeen = poll;
+                    known.records = 0;
+                }
+                known.records++;
+            }
+            std::erase_if(state.accountingKnown, [poll](const auto& entry) {
+                return entry.second.lastSeen != poll;
+            });
+
+            unsigned int budget = ACCOUNTING_QUERIES_PER_POLL;
+            size_t firstNew = sample.exitedProcesses.size();
+            for (unsigned int i = 0; i < pidCount && budget > 0; i++) {
+                unsigned int pid = pids[i];
+                auto it = state.accountingKnown.find(pid);
+                if (it == state.accountingKnown.end()) continue;  // Running, in the process list
+                auto& known = it->second;
+                // Seeded history, or older records of the PID the driver has since dropped
+                if (seeding || known.records < known.recordsRead) known.recordsRead = known.records;
+                bool newRecord = known.records > known.recordsRead;
+                bool retry = known.retryPoll != 0 && poll >= known.retryPoll;
+                if (!newRecord && !retry) continue;
+
+                budget--;
+                known.recordsRead = known.records;
+                known.retryPoll = 0;
+                nvmlAccountingStats_t stats;
+                if (timedCall(calls, NVML_FN(nvmlDeviceGetAccountingStats), device, pid, &stats) != NVML_SUCCESS) {
+                    continue;
+                }
+                if (stats.isRunning) {
+                    known.retryPoll = poll + ACCOUNTING_RETRY_POLLS;
+                    continue;
+                }
+                // The driver reports the PID's latest exit, which may be the one already listed
+                auto startUs = static_cast<long long>(stats.startTime);
+                if (startUs == known.reportedStartUs) continue;
+                known.reportedStartUs = startUs;
+                ExitedProcess proc;
+                proc.pid = pid;
+                proc.startTimeUs = startUs;
+                proc.durationMs = stats.time;
+                proc.maxMemory = stats.maxMemoryUsage;
+                proc.gpuUtil = stats.gpuUtilization;
+                proc.memUtil = stats.memoryUtilization;
+                sample.exitedProcesses.push_back(std::move(proc));
+            }
+
+            // New exits in the order they ended, then keep only the most recent
+            auto endTime = [](const ExitedProcess& proc) {
+                return proc.startTimeUs + static_cast<long long>(proc.durationMs) * 1000;
+            };
+            auto& exited = sample.exitedProcesses;
+            std::ranges::sort(exited.begin() + static_cast<std::ptrdiff_t>(firstNew), exited.end(), {}, endTime);
+            if (exited.size() > MAX_EXITED_PROCESSES) {
+                exited.erase(exited.begin(), exited.end() - static_cast<std::ptrdiff_t>(MAX_EXITED_PROCESSES));
+            }
+        }
+    }
+
+    if (groups & (1u << METRIC_HEALTH)) {
+        fetchFields(METRIC_HEALTH);
+
+        // Persistence mode (Linux only, but query is safe on all platforms)
+        nvmlEnableState_t pmMode;
+        if (query(CAP_PERSISTENCE, [&] { return timedCall(calls, NVML_FN(nvmlDeviceGetPersistenceMode), device, &pmMode); })) {
+            sample.persistenceMode = (pmMode == NVML_FEATURE_ENABLED);
+        }
+
+        nvmlEnableState_t accounting;
+        if (query(CAP_ACCOUNTING, [&] {
+                return timedCall(calls, NVML_FN(nvmlDeviceGetAccountingMode), device, &accounting);
+            })) {
+            state.accountingEnabled = (accounting == NVML_FEATURE_ENABLED);
+        }
+
+        // Power limit (only changes when an administrator sets it)
+        unsigned int limit;
+        if (query(CAP_POWER_LIMIT, [&] { return timedCall(calls, NVML_FN(nvmlDeviceGetPowerManagementLimit), device, &limit); })) {
+            sample.powerLimit = limit / 1000;  // Convert mW to W
+        }
+
+        // PCIe info
+        unsigned int gen, width;
+        if (query(CAP_PCIE_GEN, [&] { return timedCall(calls, NVML_FN(nvmlDeviceGetCurrPcieLinkGeneration), device, &gen); })) {
+            sample.pcieGen = gen;
+        }
+        if (query(CAP_PCIE_WIDTH, [&] { return timedCall(calls, NVML_FN(nvmlDeviceGetCurrPcieLinkWidth), device, &width); })) {
+            sample.pcieWidth = width;
+        }
+        unsigned int replays;
+        if (auto* value = field(NVML_FI_DEV_PCIE_REPLAY_COUNTER)) {
+            sample.pcieReplays = fieldAsUnsigned(*value);
+            sample.pcieReplayRange = counterRange(*value);
+        } else if (query(CAP_PCIE_REPLAY, [&] {
+                       return timedCall(calls, NVML_FN(nvmlDeviceGetPcieReplayCounter), device, &replays);
+                   })) {
+            sample.pcieReplays = replays;
+            sample.pcieReplayRange = 1ull << 32;
+        }
+
+        // ECC errors (mode is static, only the counter changes)
+        if (auto* value = field(NVML_FI_DEV_ECC_SBE_VOL_TOTAL)) {
+            sample.eccErrors = fieldAsUnsigned(*value);
+        } else if (state.descriptor->eccEnabled) {
+            unsigned long long eccCount;
+            if (query(CAP_ECC_ERRORS, [&] {
+                    return timedCall(calls, NVML_FN(nvmlDeviceGetTotalEccErrors), device, NVML_MEMORY_ERROR_TYPE_CORRECTED,
+                        NVML_VOLATILE_ECC, &eccCount);
+                })) {
+                sample.eccErrors = eccCount;
+            }
+        }
+    }
+    return true;
+}
+
+void NvmlBackend::querySystemInfo(SystemInfo& info) {
+    if (!m_initialized) return;
+
+    // Driver version
+    char driverVersion[NVML_SYSTEM_DRIVER_VERSION_BUFFER_SIZE];
+    if (timedCall(m_systemCalls, NVML_FN(nvmlSystemGetDriverVersion), driverVersion, sizeof(driverVersion)) == NVML_SUCCESS) {
+        info.driverVersion = driverVersion;
+    }
+
+    // CUDA version (NVML reports as int like 12090 for 12.9)
+    int cudaVersion;
+    if (timedCall(m_systemCalls, NVML_FN(nvmlSystemGetCudaDriverVersion), &cudaVersion) == NVML_SUCCESS) {
+        int major = cudaVersion / 1000;
+        int minor = (cudaVersion % 1000) / 10;
+        info.cudaVersion = std::to_string(major) + "." + std::to_string(minor);
+    }
+
+    // Interconnect matrix (uses cached handles and bus IDs). Only queried here, i.e. once
+    // per enumeration, as it takes a few calls per GPU pair.
+    size_t count = m_devices.size();
+    auto topology = std::make_shared<GpuTopology>();
+    topology->links.resize(count * count);
+    for (const auto& state : m_devices) {
+        topology->cudaIndices.push_back(state.descriptor->cudaIndex);
+    }
+    auto peer = [&](size_t row, size_t column) -> GpuPeerLink& {
+        return topology->links[row * count + column];
+    };
+
+    // NVLink: count the active links from each GPU to each other GPU. Links to NVSwitches
+    // and CPUs end at devices that are not in the bus ID map.
+    info.nvlinkAvailable = false;
+    for (size_t a = 0; a < count; a++) {
+        Device& state = m_devices[a];
+        unsigned int i = state.descriptor->cudaIndex;
+
+        for (unsigned int link = 0; link < state.descriptor->nvlinkLinks; link++) {
+            nvmlEnableState_t isActive;
+            if (!queryIfSupported(state.capabilities, CAP_NVLINK, m_callsAvoided, [&] {
+                    return timedCall(*state.calls, NVML_FN(nvmlDeviceGetNvLinkState), state.handle, link, &isActive);
+                })) {
+                continue;
+            }
+            if (isActive != NVML_FEATURE_ENABLED) continue;
+            info.nvlinkAvailable = true;
+
+            // Get remote GPU info
+            nvmlPciInfo_t remotePci;
+            if (timedCall(*state.calls, NVML_FN(nvmlDeviceGetNvLinkRemotePciInfo), state.handle, link,
+                             &remotePci) != NVML_SUCCESS) {
+                continue;
+            }
+            auto other = m_busIdIndex.find(remotePci.busId);
+            if (other == m_busIdIndex.end() || other->second == a) continue;
+
+            GpuPeerLink& target = peer(a, other->second);
+            target.nvlinkCount++;
+            unsigned int version;
+            if (timedCall(*state.calls, NVML_FN(nvmlDeviceGetNvLinkVersion), state.handle, link,
+                          &version) == NVML_SUCCESS) {
+                target.nvlinkVersion = std::max(target.nvlinkVersion, version);
+            }
+
+            unsigned int j = m_devices[other->second].descriptor->cudaIndex;
+            auto pair = std::make_pair(
+                static_cast<int>(std::min(i, j)),
+                static_cast<int>(std::max(i, j)));
+            // Avoid duplicates (each link is seen from both ends)
+            if (std::find(info.nvlinkPairs.begin(), info.nvlinkPairs.end(), pair) == info.nvlinkPairs.end()) {
+                info.nvlinkPairs.push_back(pair);
+            }
+        }
+    }
+
+    // PCIe placement and peer-to-peer support, queried once per pair and mirrored
+    for (size_t a = 0; a < count; a++) {
+        Device& state = m_devices[a];
+        for (size_t b = a + 1; b < count; b++) {
+            nvmlDevice_t other = m_devices[b].handle;
+            GpuPeerLink& forward = peer(a, b);
+
+            nvmlGpuTopologyLevel_t level;
+            if (queryIfSupported(state.capabilities, CAP_TOPOLOGY, m_callsAvoided, [&] {
+                    return timedCall(*state.calls, NVML_FN(nvmlDeviceGetTopologyCommonAncestor),
+                                     state.handle, other, &level);
+                })) {
+                forward.level = topologyLevel(level);
+            }
+
+            auto p2p = [&](nvmlGpuP2PCapsIndex_t capability) {
+                nvmlGpuP2PStatus_t status;
+                return queryIfSupported(state.capabilities, CAP_P2P_STATUS, m_callsAvoided, [&] {
+                           return timedCall(*state.calls, NVML_FN(nvmlDeviceGetP2PStatus),
+                                            state.handle, other, capability, &status);
+                       }) && status == NVML_P2P_STATUS_OK;
+            };
+            forward.p2pRead = p2p(NVML_P2P_CAPS_INDEX_READ);
+            forward.p2pWrite = p2p(NVML_P2P_CAPS_INDEX_WRITE);
+            forward.p2pAtomics = p2p(NVML_P2P_CAPS_INDEX_ATOMICS);
+            forward.p2pNvlink = p2p(NVML_P2P_CAPS_INDEX_NVLINK);
+
+            // The reverse direction keeps the links counted from its own end
+            GpuPeerLink& reverse = peer(b, a);
+            unsigned int reverseLinks = reverse.nvlinkCount;
+            unsigned int reverseVersion = reverse.nvlinkVersion;
+            reverse = forward;
+            reverse.nvlinkCount = reverseLinks;
+            reverse.nvlinkVersion = reverseVersion;
+        }
+    }
+    info.topology = std::move(topology);
+}
+
+unsigned long long NvmlBackend::callsAvoided() const {
+    return m_callsAvoided.load(std::memory_order_relaxed);
+}
+
+NvmlCallTable& NvmlBackend::callTable(const std::string& uuid) {
+    std::lock_guard<std::mutex> lock(m_callMutex);
+    auto it = std::ranges::find(m_callTables, uuid, [](const auto& entry) { return entry.first; });
+    if (it != m_callTables.end()) return *it->second;
+    m_callTables.emplace_back(uuid, std::make_unique<NvmlCallTable>());
+    return *m_callTables.back().second;
+}
+
+std::vector<CallLatency> NvmlBackend::callLatency() const {
+    // Functions never called (unsupported, skipped by capability caching) are left out
+    std::vector<CallLatency> result;
+    auto append = [&](const std::string& uuid, const NvmlCallTable& table) {
+        for (int function = 0; function < NVML_FUNCTION_COUNT; function++) {
+            const NvmlCallStats& stats = table[function];
+            if (stats.latency.count() == 0) continue;
+            CallLatency entry;
+            entry.function = nvmlFunctionName(static_cast<NvmlFunction>(function));
+            entry.deviceUuid = uuid;
+            entry.calls = stats.latency.count();
+            entry.errors = stats.errors.load(std::memory_order_relaxed);
+            entry.p50Us = stats.latency.percentile(50.0);
+            entry.p99Us = stats.latency.percentile(99.0);
+            entry.maxUs = stats.latency.max();
+            result.push_back(entry);
+        }
+    };
+
+    append({}, m_systemCalls);
+    std::lock_guard<std::mutex> lock(m_callMutex);
+    for (const auto& [uuid, table] : m_callTables) {
+        append(uuid, *table);
+    }
+    return result;
+}
@@ -0,0 +1,274 @@
+#pragma once
+
+#include "backend/gpu_backend.h"
+#include "backend/nvml_api.h"
+#include "latency_histogram.h"
+
+#include <nvml.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+// Optional per-device NVML queries. All bits start set; a bit is cleared the first
+// time its query returns NVML_ERROR_NOT_SUPPORTED and the query is skipped from then on.
+enum GpuCapability : unsigned int {
+    CAP_PERSISTENCE        = 1u << 0,
+    CAP_MEMORY             = 1u << 1,
+    CAP_UTILIZATION        = 1u << 2,
+    CAP_TEMPERATURE        = 1u << 3,
+    CAP_FAN_SPEED          = 1u << 4,
+    CAP_POWER_USAGE        = 1u << 5,
+    CAP_POWER_LIMIT        = 1u << 6,
+    CAP_GPU_CLOCK          = 1u << 7,
+    CAP_MEM_CLOCK          = 1u << 8,
+    CAP_PCIE_GEN           = 1u << 9,
+    CAP_PCIE_WIDTH         = 1u << 10,
+    CAP_COMPUTE_PROCESSES  = 1u << 11,
+    CAP_GRAPHICS_PROCESSES = 1u << 12,
+    CAP_ECC_ERRORS         = 1u << 13,
+    CAP_NVLINK             = 1u << 14,
+    CAP_FIELD_VALUES       = 1u << 15,  // Batched nvmlDeviceGetFieldValues path
+    CAP_GPU_UTIL_SAMPLES   = 1u << 16,  // nvmlDeviceGetSamples buffers
+    CAP_MEM_UTIL_SAMPLES   = 1u << 17,
+    CAP_POWER_SAMPLES      = 1u << 18,
+    CAP_GPU_CLOCK_SAMPLES  = 1u << 19,
+    CAP_MEM_CLOCK_SAMPLES  = 1u << 20,
+    CAP_MPS_PROCESSES      = 1u << 21,
+    CAP_PROCESS_UTILIZATION = 1u << 22,
+    CAP_ACCOUNTING         = 1u << 23,
+    CAP_TOPOLOGY           = 1u << 24,
+    CAP_P2P_STATUS         = 1u << 25,
+    CAP_CLOCK_REASONS      = 1u << 26,
+    CAP_ENERGY             = 1u << 27,
+    CAP_MIG                = 1u << 28,
+    CAP_GPM                = 1u << 29,
+    CAP_PCIE_REPLAY        = 1u << 30,
+    CAP_ALL                = ~0u
+};
+
+// Latency and failures of one NVML entry point
+struct NvmlCallStats {
+    LatencyHistogram latency;
+    std::atomic<unsigned long long> errors{0};
+};
+using NvmlCallTable = std::array<NvmlCallStats, NVML_FUNCTION_COUNT>;
+
+struct nvmlDevice_st;
+struct nvmlEventSet_st;
+struct nvmlGpmSample_st;
+
+// Real hardware via NVML
+class NvmlBackend : public GpuBackend {
+public:
+    NvmlBackend() = default;
+    // Use `api` instead of the driver's library (a fake driver, for the benchmarks)
+    explicit NvmlBackend(const NvmlApi* api) : m_nvml(api) {}
+    ~NvmlBackend() override;
+
+    bool initialize() override;
+    void shutdown() override;
+    const char* name() const override { return "NVML"; }
+
+    bool getDeviceCount(unsigned int& count) override;
+    std::vector<std::shared_ptr<const GpuDescriptor>> enumerateDevices() override;
+    bool collect(size_t device, unsigned int groups, GpuSample& sample) override;
+    void querySystemInfo(SystemInfo& info) override;
+    unsigned long long callsAvoided() const override;
+    std::vector<CallLatency> callLatency() const override;
+
+    bool supportsEvents() const override { return m_eventSet != nullptr; }
+    bool waitForEvent(unsigned int timeoutMs, DeviceEvent& event) override;
+
+private:
+    // One value requested through nvmlDeviceGetFieldValues (NVML_FI_* id and scope)
+    struct FieldRequest {
+        unsigned int fieldId;
+        unsigned int scopeId;
+    };
+
+    // Where a PID's merged entry lives in GpuSample::processes
+    struct ProcessSlot {
+        size_t index;                  // Position in GpuSample::processes
+        unsigned int list;             // Last process list the PID appeared in
+        unsigned long long listMemory; // Memory summed over that list's entries
+        unsigned int utilSamples;      // Utilization samples summed into the process
+    };
+
+    // Open-addressed key -> value table for one poll's process merge (linear probing, at
+    // most half full). A slot stamped with an earlier poll counts as empty, so starting a
+    // poll is one increment and the slots, sized for the largest list seen, are reused
+    // instead of freed.
+    template <typename Key, typename Value>
+    class PollTable {
+    public:
+        // Empty the table for a new poll
+        void reset() {
+            m_count = 0;
+            if (++m_poll == 0) {  // Stamp wrapped: clear the old ones once
+                for (auto& slot : m_slots) slot.poll = 0;
+                m_poll = 1;
+            }
+        }
+
+        Value* find(Key key) {
+            if (m_slots.empty()) return nullptr;
+            size_t mask = m_slots.size() - 1;
+            for (size_t i = hash(key) & mask;; i = (i + 1) & mask) {
+                Slot& slot = m_slots[i];
+                if (slot.poll != m_poll) return nullptr;
+                if (slot.key == key) return &slot.value;
+            }
+        }
+
+        // Entry for `key`, set to `value` first if the key is new (then the flag is true)
+        std::pair<Value*, bool> tryEmplace(Key key, const Value& value) {
+            if (Value* existing = find(key)) return {existing, false};
+            if ((m_count + 1) * 2 > m_slots.size()) rehash(std::max<size_t>(64, m_slots.size() * 2));
+            Slot& slot = m_slots[probe(key)];
+            slot = Slot{key, m_poll, value};
+            m_count++;
+            return {&slot.value, true};
+        }
+
+        // Call fn(key, value) for every entry of this poll
+        template <typename Fn>
+        void forEach(Fn&& fn) {
+            for (auto& slot : m_slots) {
+                if (slot.poll == m_poll) fn(slot.key, slot.value);
+            }
+        }
+
+    private:
+        struct Slot {
+            Key key{};
+            unsigned int poll{0};  // Poll that filled the slot
+            Value value{};
+        };
+
+        // Multiplicative hash: keys are PIDs, some with an instance index in the high bits
+        static size_t hash(Key key) {
+            return static_cast<size_t>((static_cast<unsigned long long>(key) * 0x9E3779B97F4A7C15ull) >> 32);
+        }
+
+        // First free slot for `key`
+        size_t probe(Key key) const {
+            size_t mask = m_slots.size() - 1;
+            size_t i = hash(key) & mask;
+            while (m_slots[i].poll == m_poll) {
+                i = (i + 1) & mask;
+            }
+            return i;
+        }
+
+        void rehash(size_t capacity) {
+            std::vector<Slot> old = std::move(m_slots);
+            m_slots.assign(capacity, Slot{});
+            for (auto& slot : old) {
+                if (slot.poll == m_poll) m_slots[probe(slot.key)] = slot;
+            }
+        }
+
+        std::vector<Slot> m_slots;  // Power-of-two size
+        size_t m_count{0};
+        unsigned int m_poll{1};
+    };
+
+    // Two GPM sample buffers used in turn: each poll fills the older one, and the
+    // metrics are the difference to the other
+    struct GpmSamples {
+        std::array<nvmlGpmSample_st*, 2> buffers{};
+        int newest{-1};  // Buffer holding the latest sample (-1 before the first)
+    };
+
+    // Per-device state, cached across polls
+    struct Device {
+        std::shared_ptr<const GpuDescriptor> descriptor;
+        nvmlDevice_st* handle{nullptr};
+        unsigned int capabilities{CAP_ALL};  // GpuCapability bits
+        NvmlCallTable* calls{nullptr};       // Timing of this device's calls (see m_callTables)
+
+        // Fields batched into one call per metric group. A field the device reports as
+        // unsupported is dropped, and its value comes from the individual query instead.
+        std::array<std::vector<FieldRequest>, METRIC_GROUP_COUNT> fields;
+
+        // Driver sample buffers: newest timestamp already read, and buffer size per trace
+        std::array<unsigned long long, TRACE_COUNT> sampleCursor{};
+        std::array<unsigned int, TRACE_COUNT> sampleCapacity{};
+
+        // Process enumeration, kept between polls so a steady process list reuses them:
+        // the buffer grows to the largest list seen, and pid -> merged entry for this poll
+        std::vector<nvmlProcessInfo_t> processBuffer;
+        PollTable<unsigned int, ProcessSlot> processSlots;
+        // (MIG instance index << 32 | pid) -> entry in that instance's process list
+        PollTable<unsigned long long, size_t> migProcessSlots;
+        // The process list of the previous poll, whose names carry over to PIDs still
+        // running; swapped with GpuSample::processes so both keep their capacity
+        std::vector<GpuProcess> previousProcesses;
+
+        // Handle of each GpuSample::migInstances entry, from the last MIG layout read
+        std::vector<nvmlDevice_st*> migHandles;
+
+        // GPM sample pairs, allocated on first use: the device's, and one per GPU
+        // instance ID while MIG is enabled
+        GpmSamples gpm;
+        std::unordered_map<unsigned int, GpmSamples> migGpm;
+
+        // Per-process utilization samples and the newest timestamp already read
+        std::vector<nvmlProcessUtilizationSample_t> processUtilBuffer;
+        unsigned long long processUtilCursor{0};
+
+        // Accounting mode: PIDs in the driver's accounting buffer, and the ones already
+        // handled. lastSeen is the poll that last found the PID, so entries the driver has
+        // dropped can be forgotten. records is how many times the buffer lists the PID and
+        // recordsRead that count when its stats were last read, so a reused PID shows up as
+        // a new record. retryPoll is when a still-running PID is queried again (0: not
+        // until it gets a new record), and reportedStartUs is the start time of the exit
+        // last reported for it.
+        struct AccountingPid {
+            unsigned int lastSeen{0};
+            unsigned int records{0};
+            unsigned int recordsRead{0};
+            unsigned int retryPoll{0};
+            long long reportedStartUs{-1};
+        };
+        bool accountingEnabled{false};
+        std::vector<unsigned int> accountingPids;
+        std::unordered_map<unsigned int, AccountingPid> accountingKnown;
+        unsigned int accountingPoll{0};
+    };
+
+    // Timing table for a device's calls, created on first use
+    NvmlCallTable& callTable(const std::string& uuid);
+
+    // Whether the driver supports GPM on the device (Hopper and later)
+    bool gpmSupported(Device& state);
+
+    // Take a GPM sample (of one GPU instance when `gpuInstanceId` is set) and compute the
+    // metrics since the previous one. Leaves `metrics` invalid until two samples exist.
+    void readGpm(Device& state, GpmSamples& samples, std::optional<unsigned int> gpuInstanceId,
+                 GpmMetrics& metrics);
+    void freeGpm(GpmSamples& samples, NvmlCallTable& calls);
+    void releaseDevices(std::vector<Device>& devices);  // Frees their driver allocations, empties the list
+
+    const NvmlApi* m_nvml{nullptr};  // Resolved at initialize() unless given
+    std::vector<Device> m_devices;   // NVML index order
+    std::unordered_map<std::string, size_t> m_busIdIndex;  // PCI bus ID -> m_devices index
+    std::atomic<unsigned long long> m_callsAvoided{0};
+
+    // Call timing per device UUID, plus calls that are not about one device. Tables are
+    // never removed, so a device that falls off the bus keeps its history, and Device
+    // can point into them across re-enumeration. The lock covers the list, not the counters.
+    mutable std::mutex m_callMutex;
+    std::vector<std::pair<std::string, std::unique_ptr<NvmlCallTable>>> m_callTables;
+    NvmlCallTable m_systemCalls;
+
+    // Event set every device is registered with, and the handle -> descriptor map the
+    // event thread uses to tag events (rebuilt with m_devices, hence the lock)
+    nvmlEventSet_st* m_eventSet{nullptr};
+    std::mutex m_eventMutex;
+    std::vector<std::pair<nvmlDevice_st*, std::shared_ptr<const GpuDescriptor>>> m_eventDevices;
+    bool m_initialized{false};
+};
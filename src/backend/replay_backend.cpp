@@ -0,0 +1,249 @@
+#include "backend/replay_backend.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <sstream>
+
+namespace {
+
+// Columns ReplayRecorder writes, in order (ReplayBackend accepts any order)
+constexpr const char* RECORDED_COLUMNS =
+    "time_ms,bus_id,uuid,name,gpu_util,mem_util,vram_used,vram_total,temperature,fan_speed,"
+    "power_draw,power_draw_mw,power_limit,gpu_clock,mem_clock,pcie_gen,pcie_width,ecc_errors";
+
+std::vector<std::string> splitCsvLine(const std::string& line) {
+    std::vector<std::string> fields;
+    std::stringstream ss(line);
+    std::string field;
+    while (std::getline(ss, field, ',')) {
+        if (!field.empty() && field.back() == '\r') field.pop_back();
+        fields.push_back(field);
+    }
+    return fields;
+}
+
+} // namespace
+
+ReplayBackend::ReplayBackend(std::string path)
+    : m_path(std::move(path)) {
+}
+
+bool ReplayBackend::initialize() {
+    std::ifstream file(m_path);
+    if (!file) return false;
+
+    std::string line;
+    if (!std::getline(file, line)) return false;
+
+    // Column name -> position
+    std::map<std::string, size_t> columns;
+    auto header = splitCsvLine(line);
+    for (size_t i = 0; i < header.size(); i++) {
+        columns[header[i]] = i;
+    }
+    if (!columns.contains("time_ms") || !columns.contains("bus_id")) return false;
+
+    std::map<std::string, size_t> trackByBusId;
+    m_tracks.clear();
+
+    while (std::getline(file, line)) {
+        auto fields = splitCsvLine(line);
+        if (fields.size() < header.size()) continue;
+
+        auto text = [&](const char* column) -> std::string {
+            auto it = columns.find(column);
+            return it != columns.end() ? fields[it->second] : std::string();
+        };
+        auto number = [&](const char* column) -> unsigned long long {
+            std::string value = text(column);
+            return value.empty() ? 0 : std::strtoull(value.c_str(), nullptr, 10);
+        };
+        auto u32 = [&](const char* column) {
+            return static_cast<unsigned int>(number(column));
+        };
+
+        std::string busId = text("bus_id");
+        auto [it, inserted] = trackByBusId.try_emplace(busId, m_tracks.size());
+        if (inserted) {
+            Track track;
+            track.descriptor = std::make_shared<GpuDescriptor>();
+            track.descriptor->pciBusId = busId;
+            track.descriptor->uuid = text("uuid");
+            track.descriptor->name = text("name");
+            m_tracks.push_back(std::move(track));
+        }
+        Track& track = m_tracks[it->second];
+
+        TimedSample timed{};
+        timed.timeMs = std::strtod(text("time_ms").c_str(), nullptr);
+        GpuSample& s = timed.sample;
+        s.gpuUtilization = u32("gpu_util");
+        s.memUtilization = u32("mem_util");
+        s.vramUsed = number("vram_used");
+        s.vramTotal = number("vram_total");
+        s.temperature = u32("temperature");
+        s.fanSpeed = u32("fan_speed");
+        s.powerDraw = u32("power_draw");
+        s.powerDrawMw = columns.contains("power_draw_mw") ? u32("power_draw_mw") : s.powerDraw * 1000;
+        s.powerLimit = u32("power_limit");
+        s.gpuClock = u32("gpu_clock");
+        s.memClock = u32("mem_clock");
+        s.pcieGen = u32("pcie_gen");
+        s.pcieWidth = u32("pcie_width");
+        s.eccErrors = number("ecc_errors");
+
+        // The recording has no max clocks; use the highest value seen
+        track.descriptor->gpuClockMax = std::max(track.descriptor->gpuClockMax, s.gpuClock);
+        track.descriptor->memClockMax = std::max(track.descriptor->memClockMax, s.memClock);
+        track.samples.push_back(std::move(timed));
+    }
+    if (m_tracks.empty()) return false;
+
+    // Device order and CUDA indices follow first appearance in the file
+    double firstMs = INFINITY, lastMs = -INFINITY;
+    for (size_t i = 0; i < m_tracks.size(); i++) {
+        auto& samples = m_tracks[i].samples;
+        std::ranges::stable_sort(samples, {}, &TimedSample::timeMs);
+        firstMs = std::min(firstMs, samples.front().timeMs);
+        lastMs = std::max(lastMs, samples.back().timeMs);
+        m_tracks[i].descriptor->cudaIndex = static_cast<unsigned int>(i);
+    }
+    m_startMs = firstMs;
+    m_durationMs = lastMs - firstMs;
+    m_start = std::chrono::steady_clock::now();
+    return true;
+}
+
+void ReplayBackend::shutdown() {
+    m_tracks.clear();
+}
+
+bool ReplayBackend::getDeviceCount(unsigned int& count) {
+    count = static_cast<unsigned int>(m_tracks.size());
+    return true;
+}
+
+std::vector<std::shared_ptr<const GpuDescriptor>> ReplayBackend::enumerateDevices() {
+    std::vector<std::shared_ptr<const GpuDescriptor>> descriptors;
+    for (const auto& track : m_tracks) {
+        descriptors.push_back(track.descriptor);
+    }
+    return descriptors;
+}
+
+bool ReplayBackend::collect(size_t device, unsigned int groups, GpuSample& sample) {
+    const Track& track = m_tracks[device];
+
+    // Position in the recording, wrapping around at the end
+    double elapsedMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - m_start).count();
+    double t = m_startMs + (m_durationMs > 0.0 ? std::fmod(elapsedMs, m_durationMs) : 0.0);
+
+    // Latest recorded sample at or before t
+    auto it = std::ranges::upper_bound(track.samples, t, {}, &TimedSample::timeMs);
+    const GpuSample& recorded = (it == track.samples.begin() ? it : std::prev(it))->sample;
+
+    if (groups & (1u << METRIC_UTILIZATION)) {
+        sample.gpuUtilization = recorded.gpuUtilization;
+        sample.memUtilization = recorded.memUtilization;
+        sample.powerDraw = recorded.powerDraw;
+        sample.powerDrawMw = recorded.powerDrawMw;  // No energy counter in the recording
+    }
+    if (groups & (1u << METRIC_THERMAL)) {
+        sample.temperature = recorded.temperature;
+        sample.fanSpeed = recorded.fanSpeed;
+        sample.gpuClock = recorded.gpuClock;
+        sample.memClock = recorded.memClock;
+    }
+    if (groups & (1u << METRIC_PROCESSES)) {
+        sample.vramUsed = recorded.vramUsed;
+        sample.vramTotal = recorded.vramTotal;
+        sample.processes.clear();  // Not recorded
+    }
+    if (groups & (1u << METRIC_HEALTH)) {
+        sample.persistenceMode = recorded.persistenceMode;
+        sample.powerLimit = recorded.powerLimit;
+        sample.pcieGen = recorded.pcieGen;
+        sample.pcieWidth = recorded.pcieWidth;
+        sample.eccErrors = recorded.eccErrors;
+    }
+    return true;
+}
+
+void ReplayBackend::querySystemInfo(SystemInfo& info) {
+    info.driverVersion = "replay";
+    info.cudaVersion = "-";
+    info.nvlinkAvailable = false;
+}
+
+ReplayRecorder::ReplayRecorder(const std::string& path)
+    : m_file(path, std::ios::out | std::ios::trunc) {
+    if (m_file) {
+        m_file << RECORDED_COLUMNS << '\n';
+        m_file.flush();
+    }
+    m_open = m_file.is_open() && m_file.good();
+    if (m_open) {
+        m_writer = std::jthread([this](std::stop_token stopToken) {
+            writerThread(stopToken);
+        });
+    }
+}
+
+ReplayRecorder::~ReplayRecorder() {
+    // The writer empties the queue before it sees the stop request
+    if (m_writer.joinable()) {
+        m_writer.request_stop();
+        m_writer.join();
+    }
+}
+
+void ReplayRecorder::enqueue(std::shared_ptr<const GpuSnapshot> snapshot) {
+    if (!m_open) return;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.push_back(std::move(snapshot));
+    }
+    m_queued.notify_one();
+}
+
+void ReplayRecorder::writerThread(std::stop_token stopToken) {
+    std::vector<std::shared_ptr<const GpuSnapshot>> batch;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_queued.wait(lock, stopToken, [this] { return !m_queue.empty(); });
+            batch.swap(m_queue);
+        }
+        if (batch.empty()) return;  // Stopped with nothing left to write
+
+        for (const auto& snapshot : batch) {
+            write(*snapshot);
+        }
+        m_file.flush();
+        batch.clear();
+    }
+}
+
+void ReplayRecorder::write(const GpuSnapshot& snapshot) {
+    double timeMs = snapshot.captured.wallUs / 1000.0;
+    for (const auto& gpu : snapshot.gpus) {
+        if (gpu.gone || !gpu.device) continue;
+
+        // Fields are unquoted, so a comma in the name would shift the columns
+        std::string name = gpu.device->name;
+        std::ranges::replace(name, ',', ' ');
+
+        char row[512];
+        snprintf(row, sizeof(row), "%.3f,%s,%s,%s,%u,%u,%llu,%llu,%u,%u,%u,%u,%u,%u,%u,%u,%u,%llu\n",
+                 timeMs, gpu.device->pciBusId.c_str(), gpu.device->uuid.c_str(), name.c_str(),
+                 gpu.gpuUtilization, gpu.memUtilization, gpu.vramUsed, gpu.vramTotal,
+                 gpu.temperature, gpu.fanSpeed, gpu.powerDraw, gpu.powerDrawMw, gpu.powerLimit,
+                 gpu.gpuClock, gpu.memClock, gpu.pcieGen, gpu.pcieWidth, gpu.eccErrors);
+        m_file << row;
+    }
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "backend/gpu_backend.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+// Plays back samples recorded to CSV, looping at the end of the file.
+//
+// The first line is a header naming the columns; order is free and unknown columns are
+// ignored. Recognised columns:
+//   time_ms, bus_id, uuid, name,
+//   gpu_util, mem_util, vram_used, vram_total, temperature, fan_speed,
+//   power_draw, power_draw_mw, power_limit, gpu_clock, mem_clock, pcie_gen, pcie_width,
+//   ecc_errors
+// Each row is one device at one point in time; rows are grouped into devices by bus_id.
+// power_draw_mw keeps the driver's milliwatt reading; files without it play back
+// power_draw (whole watts).
+// Values are unquoted and use the same units as GpuSample. ReplayRecorder writes this
+// format (`gpu_monitor --record=FILE`).
+class ReplayBackend : public GpuBackend {
+public:
+    explicit ReplayBackend(std::string path);
+
+    bool initialize() override;  // Loads the whole file; fails if it is unreadable or empty
+    void shutdown() override;
+    const char* name() const override { return "Replay"; }
+
+    bool getDeviceCount(unsigned int& count) override;
+    std::vector<std::shared_ptr<const GpuDescriptor>> enumerateDevices() override;
+    bool collect(size_t device, unsigned int groups, GpuSample& sample) override;
+    void querySystemInfo(SystemInfo& info) override;
+
+private:
+    struct TimedSample {
+        double timeMs;
+        GpuSample sample;
+    };
+
+    // Recorded samples for one device, sorted by time
+    struct Track {
+        std::shared_ptr<GpuDescriptor> descriptor;
+        std::vector<TimedSample> samples;
+    };
+
+    std::string m_path;
+    std::vector<Track> m_tracks;
+    double m_startMs{0.0};
+    double m_durationMs{0.0};
+    std::chrono::steady_clock::time_point m_start;
+};
+
+// Writes published snapshots in the format ReplayBackend reads: one row per device per
+// snapshot, timed by the snapshot's wall-clock capture time. Devices marked gone are
+// left out. Snapshots are queued (see GpuMonitor::setSnapshotListener) and written on
+// the recorder's own thread, so the file is never touched by the poller or the UI. The
+// file is flushed after each batch, so it stays usable if the app is killed.
+class ReplayRecorder {
+public:
+    explicit ReplayRecorder(const std::string& path);  // Truncates the file, writes the header
+    ~ReplayRecorder();                                  // Writes what is still queued
+
+    ReplayRecorder(const ReplayRecorder&) = delete;
+    ReplayRecorder& operator=(const ReplayRecorder&) = delete;
+
+    bool isOpen() const { return m_open; }
+
+    // Queue a snapshot for writing. Only takes a lock to append the pointer.
+    void enqueue(std::shared_ptr<const GpuSnapshot> snapshot);
+
+private:
+    void writerThread(std::stop_token stopToken);
+    void write(const GpuSnapshot& snapshot);
+
+    std::ofstream m_file;  // Written by the writer thread only
+    bool m_open{false};
+
+    std::mutex m_mutex;
+    std::condition_variable_any m_queued;
+    std::vector<std::shared_ptr<const GpuSnapshot>> m_queue;
+    std::jthread m_writer;  // Last, so it starts after everything it uses
+};
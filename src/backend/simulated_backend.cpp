@@ -0,0 +1,279 @@
+#include "backend/simulated_backend.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+// Simulated MIG geometry: compute slices per GPU and multiprocessors per slice (A100-like)
+constexpr unsigned int SIMULATED_MIG_SLICES = 7;
+constexpr unsigned int SIMULATED_MIG_SMS_PER_SLICE = 14;
+
+// Simulated NVLink bridge between GPU pairs: link count and per-link peak rate per direction
+constexpr unsigned int SIMULATED_NVLINK_LINKS = 4;
+constexpr double SIMULATED_NVLINK_BYTES_PER_SEC = 25e9;
+
+double Waveform::at(double t) const {
+    constexpr double PI = 3.14159265358979323846;
+    double phase = periodSec > 0.0 ? std::fmod(t / periodSec, 1.0) : 0.0;
+    if (phase < 0.0) phase += 1.0;
+
+    double value = 0.0;
+    switch (shape) {
+        case Constant: value = 0.0; break;
+        case Sine:     value = std::sin(2.0 * PI * phase); break;
+        case Square:   value = phase < 0.5 ? 1.0 : -1.0; break;
+        case Sawtooth: value = 2.0 * phase - 1.0; break;
+        case Triangle: value = 1.0 - 4.0 * std::abs(phase - 0.5); break;
+    }
+    return base + amplitude * value;
+}
+
+double Waveform::integral(double t) const {
+    constexpr double PI = 3.14159265358979323846;
+    if (shape == Constant || periodSec <= 0.0) return base * t;
+
+    // Every shape averages to zero over a whole period, so only the partial period
+    // contributes beyond base * t
+    double phase = std::fmod(t / periodSec, 1.0);
+    if (phase < 0.0) phase += 1.0;
+    double partial = 0.0;  // Integral of shape() over [0, phase], in periods
+    switch (shape) {
+        case Constant: break;
+        case Sine:     partial = (1.0 - std::cos(2.0 * PI * phase)) / (2.0 * PI); break;
+        case Square:   partial = phase < 0.5 ? phase : 1.0 - phase; break;
+        case Sawtooth: partial = phase * phase - phase; break;
+        case Triangle: partial = phase < 0.5 ? 2.0 * phase * phase - phase
+                                             : 3.0 * phase - 2.0 * phase * phase - 1.0; break;
+    }
+    return base * t + amplitude * periodSec * partial;
+}
+
+SimulatedBackend::SimulatedBackend(SimulatedScript script)
+    : m_script(std::move(script)) {
+}
+
+bool SimulatedBackend::initialize() {
+    m_start = std::chrono::steady_clock::now();
+    return true;
+}
+
+double SimulatedBackend::elapsedSec() const {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+}
+
+bool SimulatedBackend::getDeviceCount(unsigned int& count) {
+    count = m_script.gpuCount;
+    return true;
+}
+
+std::vector<std::shared_ptr<const GpuDescriptor>> SimulatedBackend::enumerateDevices() {
+    std::vector<std::shared_ptr<const GpuDescriptor>> descriptors;
+    descriptors.reserve(m_script.gpuCount);
+
+    for (unsigned int i = 0; i < m_script.gpuCount; i++) {
+        auto desc = std::make_shared<GpuDescriptor>();
+        char buffer[64];
+
+        snprintf(buffer, sizeof(buffer), "Simulated GPU %u", i);
+        desc->name = buffer;
+        snprintf(buffer, sizeof(buffer), "GPU-5151a7ed-0000-0000-0000-%012u", i);
+        desc->uuid = buffer;
+        snprintf(buffer, sizeof(buffer), "00000000:%02X:00.0", 0x10 + i);
+        desc->pciBusId = buffer;
+        desc->isTCC = false;
+        desc->cudaIndex = i;
+        desc->gpuClockMax = m_script.gpuClockMax;
+        desc->memClockMax = m_script.memClockMax;
+        desc->eccSupported = true;
+        desc->eccEnabled = true;
+        desc->nvlinkLinks = (i ^ 1u) < m_script.gpuCount ? SIMULATED_NVLINK_LINKS : 0;  // Bridged pairs
+        descriptors.push_back(std::move(desc));
+    }
+    return descriptors;
+}
+
+bool SimulatedBackend::collect(size_t device, unsigned int groups, GpuSample& sample) {
+    const SimulatedScript& s = m_script;
+    double t = elapsedSec() + static_cast<double>(device) * s.gpuPhaseSec;
+
+    auto percent = [](double value) {
+        return static_cast<unsigned int>(std::clamp(value, 0.0, 100.0));
+    };
+    auto fraction = [](double value) {
+        return std::clamp(value, 0.0, 1.0);
+    };
+
+    if (groups & (1u << METRIC_UTILIZATION)) {
+        sample.gpuUtilization = percent(s.gpuUtilization.at(t));
+        sample.memUtilization = percent(s.memUtilization.at(t));
+        sample.powerDrawMw = static_cast<unsigned int>(s.powerLimit * 1000.0 * fraction(s.powerFraction.at(t)));
+        sample.powerDraw = sample.powerDrawMw / 1000;
+        sample.energyMj = static_cast<unsigned long long>(
+            s.powerLimit * 1000.0 * std::max(0.0, s.powerFraction.integral(t)));  // Ignores clamping
+
+        // Traffic counters integrate a rate of peak * (0.5 + 0.4 sin(2 pi t / period)),
+        // so they stay monotonic and the derived rates follow the utilization period
+        constexpr double PI = 3.14159265358979323846;
+        double period = s.gpuUtilization.periodSec > 0.0 ? s.gpuUtilization.periodSec : 1.0;
+        double average = 0.5 * t + 0.4 * period / (2.0 * PI) * (1.0 - std::cos(2.0 * PI * t / period));
+        auto counter = [&](double peakBytesPerSec) {
+            return static_cast<unsigned long long>(peakBytesPerSec * average);
+        };
+        double pciePeak = pcieBandwidth(5, 16);
+        sample.pcieTxBytes = counter(pciePeak * 0.6);
+        sample.pcieRxBytes = counter(pciePeak * 0.3);
+
+        unsigned int links = (static_cast<unsigned int>(device) ^ 1u) < s.gpuCount ? SIMULATED_NVLINK_LINKS : 0;
+        sample.nvlinkLinkBytes.assign(links, LinkTraffic{counter(SIMULATED_NVLINK_BYTES_PER_SEC),
+                                                         counter(SIMULATED_NVLINK_BYTES_PER_SEC)});
+        sample.nvlinkTxBytes = sample.nvlinkRxBytes = counter(SIMULATED_NVLINK_BYTES_PER_SEC) * links;
+
+        // Profiling metrics: SM activity a little under utilization (which counts a kernel
+        // on any SM), occupancy below that, tensor activity a quarter period behind, DRAM
+        // bandwidth following memory utilization; interconnect rates match the counters.
+        // With MIG they are reported per instance, each at its own phase.
+        auto gpmAt = [&](double time) {
+            GpmMetrics gpm{};
+            gpm.valid = true;
+            gpm.smActivity = std::clamp(s.gpuUtilization.at(time), 0.0, 100.0) * 0.85;
+            gpm.smOccupancy = gpm.smActivity * 0.45;
+            gpm.tensorActivity = std::clamp(s.gpuUtilization.at(time + period / 4.0), 0.0, 100.0) * 0.6;
+            gpm.dramBandwidth = std::clamp(s.memUtilization.at(time), 0.0, 100.0) * 0.9;
+            double rate = 0.5 + 0.4 * std::sin(2.0 * PI * time / period);
+            gpm.pcieTxBytesPerSec = pciePeak * 0.6 * rate;
+            gpm.pcieRxBytesPerSec = pciePeak * 0.3 * rate;
+            gpm.nvlinkTxBytesPerSec = gpm.nvlinkRxBytesPerSec = SIMULATED_NVLINK_BYTES_PER_SEC * rate * links;
+            return gpm;
+        };
+        sample.gpm = sample.migEnabled ? GpmMetrics{} : gpmAt(t);
+        for (size_t i = 0; i < sample.migInstances.size(); i++) {
+            sample.migInstances[i].gpm = gpmAt(t + static_cast<double>(i + 1) * s.gpuPhaseSec);
+        }
+    }
+
+    if (groups & (1u << METRIC_THERMAL)) {
+        sample.temperature = static_cast<unsigned int>(std::max(0.0, s.temperature.at(t)));
+        sample.memTemperature = sample.temperature + 6;  // HBM runs a little hotter
+        sample.fanSpeed = percent(s.fanSpeed.at(t));
+        double clock = fraction(s.clockFraction.at(t));
+        sample.gpuClock = static_cast<unsigned int>(s.gpuClockMax * clock);
+        sample.memClock = s.memClockMax;
+
+        // Below-max clocks are blamed on whichever waveform is near its limit. No violation
+        // time counters, like drivers that do not report them.
+        sample.clockEventReasons = 0;
+        if (clock < 0.97) {
+            if (s.powerFraction.at(t) > 0.8) sample.clockEventReasons |= CLOCK_EVENT_SW_POWER_CAP;
+            if (sample.temperature > 70) sample.clockEventReasons |= CLOCK_EVENT_SW_THERMAL;
+            if (s.gpuUtilization.at(t) < 20.0) sample.clockEventReasons |= CLOCK_EVENT_IDLE;
+        }
+    }
+
+    // MIG layout: the last GPU split into equal instances, each with an eighth of the
+    // memory per slice
+    bool mig = s.migInstances > 0 && device + 1 == s.gpuCount;
+    if ((groups & (1u << METRIC_HEALTH)) && sample.migInstances.size() != (mig ? s.migInstances : 0)) {
+        sample.migEnabled = mig;
+        sample.migInstances.clear();
+        unsigned int slices = mig ? std::max(1u, SIMULATED_MIG_SLICES / s.migInstances) : 0;
+        for (unsigned int i = 0; mig && i < s.migInstances; i++) {
+            MigInstance instance{};
+            char buffer[96];
+            snprintf(buffer, sizeof(buffer), "MIG-5151a7ed-0000-%04u-0000-%012u", static_cast<unsigned int>(device), i);
+            instance.uuid = buffer;
+            instance.vramTotal = s.vramTotal / 8 * slices;
+            snprintf(buffer, sizeof(buffer), "Simulated GPU %u MIG %ug.%llugb", static_cast<unsigned int>(device), slices,
+                     instance.vramTotal / (1024ull * 1024 * 1024));
+            instance.name = buffer;
+            instance.index = i;
+            instance.gpuInstanceId = i + 1;
+            instance.computeInstanceId = 0;
+            instance.smCount = slices * SIMULATED_MIG_SMS_PER_SLICE;
+            sample.migInstances.push_back(std::move(instance));
+        }
+    }
+
+    if (groups & (1u << METRIC_PROCESSES)) {
+        sample.vramTotal = s.vramTotal;
+        sample.vramUsed = static_cast<unsigned long long>(s.vramTotal * fraction(s.vramFraction.at(t)));
+
+        // Processes are dealt round-robin and share the device's used memory evenly.
+        // Each one follows the utilization waveform at its own phase, scaled so the
+        // processes together stay within the device total.
+        sample.processes.clear();
+        unsigned int gpuCount = std::max(s.gpuCount, 1u);
+        for (unsigned int p = static_cast<unsigned int>(device); p < s.processCount; p += gpuCount) {
+            GpuProcess proc;
+            proc.pid = 100000 + p;
+            proc.name = "sim_worker_" + std::to_string(p);
+            proc.commandLine = "python train.py --rank " + std::to_string(p);
+            proc.user = "sim";
+            proc.usedMemory = 0;
+            proc.smUtil = percent(s.gpuUtilization.at(t + p * s.gpuPhaseSec));
+            proc.memUtil = percent(s.memUtilization.at(t + p * s.gpuPhaseSec));
+            sample.processes.push_back(std::move(proc));
+        }
+        if (!sample.processes.empty()) {
+            for (auto& proc : sample.processes) {
+                proc.usedMemory = sample.vramUsed / sample.processes.size();
+                proc.smUtil /= static_cast<unsigned int>(sample.processes.size());
+                proc.memUtil /= static_cast<unsigned int>(sample.processes.size());
+            }
+        }
+
+        // On MIG the GPU's processes are dealt round-robin to the instances
+        for (auto& instance : sample.migInstances) {
+            instance.processes.clear();
+            instance.vramUsed = 0;
+        }
+        for (size_t p = 0; p < sample.processes.size() && !sample.migInstances.empty(); p++) {
+            MigInstance& instance = sample.migInstances[p % sample.migInstances.size()];
+            unsigned long long memory = std::min(sample.processes[p].usedMemory, instance.vramTotal - instance.vramUsed);
+            instance.processes.push_back({sample.processes[p].pid, memory});
+            instance.vramUsed += memory;
+        }
+    }
+
+    if (groups & (1u << METRIC_HEALTH)) {
+        sample.persistenceMode = true;
+        sample.powerLimit = s.powerLimit;
+        sample.pcieGen = 5;
+        sample.pcieWidth = 16;
+        sample.eccErrors = 0;
+    }
+    return true;
+}
+
+void SimulatedBackend::querySystemInfo(SystemInfo& info) {
+    info.driverVersion = "simulated";
+    info.cudaVersion = "-";
+    info.nvlinkAvailable = false;
+
+    // A two-socket node: GPUs in NVLink-bridged pairs behind one PCIe switch, the first
+    // half of the pairs on one NUMA node and the rest on the other
+    unsigned int count = m_script.gpuCount;
+    unsigned int pairsPerNode = std::max(1u, (count / 2 + 1) / 2);
+    auto topology = std::make_shared<GpuTopology>();
+    topology->links.resize(static_cast<size_t>(count) * count);
+    for (unsigned int i = 0; i < count; i++) {
+        topology->cudaIndices.push_back(i);
+    }
+    for (unsigned int a = 0; a < count; a++) {
+        for (unsigned int b = 0; b < count; b++) {
+            if (a == b) continue;
+            GpuPeerLink& link = topology->links[static_cast<size_t>(a) * count + b];
+            bool bridged = a / 2 == b / 2;
+            bool sameNode = a / 2 / pairsPerNode == b / 2 / pairsPerNode;
+            link.level = bridged ? TOPO_PCIE_SWITCH : sameNode ? TOPO_NUMA_NODE : TOPO_SYSTEM;
+            link.p2pRead = link.p2pWrite = sameNode;
+            link.p2pAtomics = bridged;
+            link.p2pNvlink = bridged;
+            link.nvlinkCount = bridged ? SIMULATED_NVLINK_LINKS : 0;
+            link.nvlinkVersion = bridged ? 4 : 0;
+            if (bridged && a < b) {
+                info.nvlinkAvailable = true;
+                info.nvlinkPairs.emplace_back(static_cast<int>(a), static_cast<int>(b));
+            }
+        }
+    }
+    info.topology = std::move(topology);
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "backend/gpu_backend.h"
+
+#include <chrono>
+
+// Scripted signal for one simulated metric: value(t) = base + amplitude * shape(t)
+struct Waveform {
+    enum Shape { Constant, Sine, Square, Sawtooth, Triangle };
+
+    Shape shape{Constant};
+    double base{0.0};
+    double amplitude{0.0};
+    double periodSec{10.0};
+
+    // Evaluate at time t (seconds); shape() ranges over [-1, 1]
+    double at(double t) const;
+
+    // Integral of at() from 0 to t, for simulating cumulative counters
+    double integral(double t) const;
+};
+
+// What the simulated backend generates. Every GPU runs the same waveforms, shifted by
+// gpuPhaseSec per device index, so values are a pure function of elapsed time.
+struct SimulatedScript {
+    unsigned int gpuCount{4};
+    unsigned int processCount{8};   // Spread round-robin across GPUs
+    unsigned int migInstances{3};   // Equal MIG instances on the last GPU (0 = MIG off)
+    double gpuPhaseSec{1.7};
+
+    Waveform gpuUtilization{Waveform::Sine, 55.0, 40.0, 20.0};     // %
+    Waveform memUtilization{Waveform::Triangle, 35.0, 25.0, 30.0}; // %
+    Waveform vramFraction{Waveform::Sawtooth, 0.5, 0.35, 60.0};    // of vramTotal
+    Waveform powerFraction{Waveform::Sine, 0.55, 0.35, 20.0};      // of powerLimit
+    Waveform temperature{Waveform::Sine, 62.0, 12.0, 45.0};        // Celsius
+    Waveform fanSpeed{Waveform::Sine, 50.0, 20.0, 45.0};           // %
+    Waveform clockFraction{Waveform::Square, 0.8, 0.2, 15.0};      // of max clock
+
+    unsigned long long vramTotal{80ull * 1024 * 1024 * 1024};
+    unsigned int powerLimit{700};     // Watts
+    unsigned int gpuClockMax{1980};   // MHz
+    unsigned int memClockMax{2619};   // MHz
+};
+
+// Deterministic fake devices for running without NVIDIA hardware (UI work, load tests)
+class SimulatedBackend : public GpuBackend {
+public:
+    explicit SimulatedBackend(SimulatedScript script = {});
+
+    bool initialize() override;
+    void shutdown() override {}
+    const char* name() const override { return "Simulated"; }
+
+    bool getDeviceCount(unsigned int& count) override;
+    std::vector<std::shared_ptr<const GpuDescriptor>> enumerateDevices() override;
+    bool collect(size_t device, unsigned int groups, GpuSample& sample) override;
+    void querySystemInfo(SystemInfo& info) override;
+
+private:
+    double elapsedSec() const;
+
+    SimulatedScript m_script;
+    std::chrono::steady_clock::time_point m_start;
+};
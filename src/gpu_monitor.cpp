@@ -1,13 +1,41 @@
 #include "gpu_monitor.h"
-#include "platform/platform.h"
-#include <nvml.h>
+#include "backend/nvml_backend.h"
+#include "spsc_queue.h"
+#include "worker_pool.h"
 #include <algorithm>
 #include <chrono>
-#include <cstring>
-#include <ranges>
-#include <set>
+#include <iterator>
+#include <limits>
+#include <unordered_set>
+#include <utility>
+
+CaptureTime CaptureTime::now() {
+    using namespace std::chrono;
+    CaptureTime time;
+    time.steadyUs = duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+    time.wallUs = duration_cast<microseconds>(system_clock::now().time_since_epoch()).count();
+    return time;
+}
+
+double pcieBandwidth(unsigned int gen, unsigned int width) {
+    // Per-lane transfer rate (GT/s) and line code efficiency: 8b/10b up to gen 2,
+    // 128b/130b for gen 3-5, and 242B/256B FLITs from gen 6
+    static const struct { double gigaTransfers; double efficiency; } generations[] = {
+        {2.5, 0.8}, {5.0, 0.8}, {8.0, 128.0 / 130.0}, {16.0, 128.0 / 130.0},
+        {32.0, 128.0 / 130.0}, {64.0, 242.0 / 256.0},
+    };
+    if (gen == 0 || gen > std::size(generations)) return 0.0;
+    const auto& g = generations[gen - 1];
+    return g.gigaTransfers * 1e9 * g.efficiency / 8.0 * width;
+}
+
+GpuMonitor::GpuMonitor()
+    : m_backend(std::make_unique<NvmlBackend>()) {
+}
 
-GpuMonitor::GpuMonitor() = default;
+GpuMonitor::GpuMonitor(std::unique_ptr<GpuBackend> backend)
+    : m_backend(std::move(backend)) {
+}
 
 GpuMonitor::~GpuMonitor() {
     shutdown();
@@ -16,314 +44,485 @@ GpuMonitor::~GpuMonitor() {
 bool GpuMonitor::initialize() {
     if (m_initialized) return true;
 
-    nvmlReturn_t result = nvmlInit();
-    if (result != NVML_SUCCESS) {
+    if (!m_backend->initialize()) {
         return false;
     }
 
     m_initialized = true;
-    updateStats();      // Initial poll
-    updateSystemInfo(); // Initial system info
+    updateStats();  // Initial poll (enumerates devices and queries system info)
     return true;
 }
 
 void GpuMonitor::shutdown() {
     stopPolling();
     if (m_initialized) {
-        nvmlShutdown();
+        m_backend->shutdown();
         m_initialized = false;
+        m_devices.clear();
+        m_deviceCount = 0;
+        m_rediscover = true;
     }
+    m_workerPool.reset();
 }
 
-std::string GpuMonitor::getProcessName(unsigned int pid, bool forceRefresh) {
-    // Check cache first (unless forcing refresh)
-    if (!forceRefresh) {
-        auto it = m_processNameCache.find(pid);
-        if (it != m_processNameCache.end()) {
-            return it->second;
-        }
+void GpuMonitor::setPollWorkers(unsigned int count) {
+    m_pollWorkers.store(std::max(count, 1u), std::memory_order_relaxed);
+}
+
+void GpuMonitor::setPollInterval(int tickMs) {
+    m_pollIntervalMs.store(std::max(tickMs, 1), std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_intervalChanged = true;
     }
+    m_wakeCv.notify_one();
+}
 
-    // Lookup and cache
-    std::string name = Platform::getProcessName(pid);
-    m_processNameCache[pid] = name;
-    return name;
+void GpuMonitor::setMetricGroupPeriod(MetricGroup group, int periodMs) {
+    if (group < 0 || group >= METRIC_GROUP_COUNT) return;
+    m_groupPeriodMs[group].store(std::max(periodMs, 1), std::memory_order_relaxed);
 }
 
-void GpuMonitor::updateStats() {
-    if (!m_initialized) return;
+void GpuMonitor::setAdaptivePolling(bool enabled, int minMs, int maxMs) {
+    minMs = std::max(minMs, 1);
+    m_adaptiveMinMs.store(minMs, std::memory_order_relaxed);
+    m_adaptiveMaxMs.store(std::max(maxMs, minMs), std::memory_order_relaxed);
+    m_adaptive.store(enabled, std::memory_order_relaxed);
 
-    unsigned int deviceCount = 0;
-    nvmlReturn_t result = nvmlDeviceGetCount(&deviceCount);
-    if (result != NVML_SUCCESS) return;
+    // The tick may have to tighten to the new minimum
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_intervalChanged = true;
+    }
+    m_wakeCv.notify_one();
+}
 
-    // Determine if we should refresh process names this poll
-    m_pollsSinceProcessNameUpdate++;
-    bool refreshProcessNames = (m_pollsSinceProcessNameUpdate >= m_processNameUpdateInterval);
-    if (refreshProcessNames) {
-        m_pollsSinceProcessNameUpdate = 0;
+std::chrono::milliseconds GpuMonitor::tickInterval() const {
+    int tickMs = m_pollIntervalMs.load(std::memory_order_relaxed);
+    if (m_adaptive.load(std::memory_order_relaxed)) {
+        tickMs = std::min(tickMs, m_adaptiveMinMs.load(std::memory_order_relaxed));
     }
+    return std::chrono::milliseconds(tickMs);
+}
 
-    // Track which PIDs are still active (for cache cleanup)
-    std::set<unsigned int> activePids;
+std::chrono::milliseconds GpuMonitor::groupPeriod(const DeviceState& state, int group) const {
+    std::chrono::milliseconds period(m_groupPeriodMs[group].load(std::memory_order_relaxed));
+    if (state.intervalMs == 0 || !m_adaptive.load(std::memory_order_relaxed)) return period;
 
-    std::vector<GpuStats> newStats;
-    newStats.reserve(deviceCount);
+    std::chrono::milliseconds interval(state.intervalMs);
+    return group == METRIC_UTILIZATION ? interval : std::max(period, interval);
+}
 
-    for (unsigned int i = 0; i < deviceCount; i++) {
-        nvmlDevice_t device;
-        result = nvmlDeviceGetHandleByIndex(i, &device);
-        if (result != NVML_SUCCESS) continue;
+unsigned int GpuMonitor::dueGroups(const DeviceState& state, Clock::time_point now, Clock::duration slack) const {
+    unsigned int due = 0;
+    for (int group = 0; group < METRIC_GROUP_COUNT; group++) {
+        if (now - state.lastUpdate[group] + slack >= groupPeriod(state, group)) {
+            due |= 1u << group;
+        }
+    }
+    return due;
+}
 
-        GpuStats stats{};
-        stats.cudaIndex = i;  // NVML index matches CUDA index
+void GpuMonitor::adaptInterval(DeviceState& state, unsigned int collectedGroups) {
+    if (!m_adaptive.load(std::memory_order_relaxed)) {
+        state.intervalMs = 0;
+        return;
+    }
 
-        // Name
-        char name[NVML_DEVICE_NAME_BUFFER_SIZE];
-        if (nvmlDeviceGetName(device, name, sizeof(name)) == NVML_SUCCESS) {
-            stats.name = name;
-        }
+    // Thresholds between two consecutive readings
+    constexpr unsigned int UTIL_CHANGE = 10;        // Percentage points
+    constexpr unsigned int POWER_CHANGE_W = 10;     // Or a tenth of the power limit, if larger
+    constexpr unsigned int IDLE_UTIL = 5;           // At or below: idle
 
-        // UUID (unique identifier for this specific GPU)
-        char uuid[NVML_DEVICE_UUID_BUFFER_SIZE];
-        if (nvmlDeviceGetUUID(device, uuid, sizeof(uuid)) == NVML_SUCCESS) {
-            stats.uuid = uuid;
-        }
+    int minMs = m_adaptiveMinMs.load(std::memory_order_relaxed);
+    int maxMs = m_adaptiveMaxMs.load(std::memory_order_relaxed);
+    int interval = state.intervalMs;
+    if (interval == 0) {
+        interval = m_groupPeriodMs[METRIC_UTILIZATION].load(std::memory_order_relaxed);
+    }
 
-        // PCI Bus ID (physical slot location)
-        nvmlPciInfo_t pci;
-        if (nvmlDeviceGetPciInfo(device, &pci) == NVML_SUCCESS) {
-            stats.pciBusId = pci.busId;
+    const GpuSample& sample = state.sample;
+    auto differs = [](unsigned int a, unsigned int b, unsigned int threshold) {
+        return (a > b ? a - b : b - a) >= threshold;
+    };
+    bool changed = false;
+    if (collectedGroups & (1u << METRIC_UTILIZATION)) {
+        changed |= differs(sample.gpuUtilization, state.activityUtil, UTIL_CHANGE);
+        changed |= differs(sample.powerDraw, state.activityPower,
+                           std::max(POWER_CHANGE_W, sample.powerLimit / 10));
+        state.activityUtil = sample.gpuUtilization;
+        state.activityPower = sample.powerDraw;
+    }
+    if (collectedGroups & (1u << METRIC_PROCESSES)) {
+        // Order-independent fingerprint of the PID set
+        unsigned long long signature = sample.processes.size();
+        for (const auto& proc : sample.processes) {
+            signature += (proc.pid + 1ull) * 0x9E3779B97F4A7C15ull;
         }
+        changed |= signature != state.processSignature;
+        state.processSignature = signature;
+    }
 
-        // Driver model (TCC vs WDDM) - Windows only
-        // NVML_DRIVER_WDDM = 0 (display), NVML_DRIVER_WDM = 1 (TCC/compute)
-        nvmlDriverModel_t current, pending;
-        if (nvmlDeviceGetDriverModel(device, &current, &pending) == NVML_SUCCESS) {
-            stats.isTCC = (current == NVML_DRIVER_WDM);
-        }
+    if (changed) {
+        interval = minMs;
+    } else if ((collectedGroups & (1u << METRIC_UTILIZATION)) && sample.gpuUtilization <= IDLE_UTIL) {
+        interval = (interval > maxMs / 2) ? maxMs : interval * 2;
+    }
+    state.intervalMs = std::clamp(interval, minMs, maxMs);
+}
 
-        // Persistence mode (Linux only, but query is safe on all platforms)
-        nvmlEnableState_t pmMode;
-        if (nvmlDeviceGetPersistenceMode(device, &pmMode) == NVML_SUCCESS) {
-            stats.persistenceMode = (pmMode == NVML_FEATURE_ENABLED);
-        }
+std::optional<double> GpuMonitor::counterRate(CounterReading& previous, unsigned long long value,
+                                              long long timeUs, unsigned long long range) {
+    if (timeUs <= previous.timeUs) return std::nullopt;
+    CounterReading last = std::exchange(previous, CounterReading{value, timeUs});
+    if (last.timeUs == 0) return 0.0;
+
+    // Counters are compared modulo their range (2^64 when `range` is 0, or the 32-bit range
+    // the driver reported them in), so one that wrapped still gives the amount that passed.
+    // One that went backwards (driver reload, counter reset) reads as a difference of more
+    // than half the range; that interval has no rate.
+    unsigned long long delta = value - last.value;
+    unsigned long long limit = std::numeric_limits<unsigned long long>::max() / 2;
+    if (range != 0) {
+        delta = (value >= last.value) ? value - last.value : range - last.value + value;
+        limit = range / 2;
+    }
+    if (delta > limit) return 0.0;
+    return static_cast<double>(delta) * 1e6 / static_cast<double>(timeUs - last.timeUs);
+}
 
-        // Memory
-        nvmlMemory_t memory;
-        if (nvmlDeviceGetMemoryInfo(device, &memory) == NVML_SUCCESS) {
-            stats.vramUsed = memory.used;
-            stats.vramTotal = memory.total;
+void GpuMonitor::updateRates(DeviceState& state, unsigned int collectedGroups) {
+    // Batched counters are stamped by the driver; otherwise the capture time is used.
+    // Both are wall-clock microseconds. A counter the driver has not refreshed since the
+    // previous read keeps its rate.
+    const GpuSample& sample = state.sample;
+    auto timeOf = [&](MetricGroup group) {
+        long long driverUs = sample.fieldTimestampUs[group];
+        return driverUs != 0 ? driverUs : sample.captured.wallUs;
+    };
+    auto advance = [](double& rate, std::optional<double> next) {
+        if (next) rate = *next;
+    };
+
+    if (collectedGroups & (1u << METRIC_UTILIZATION)) {
+        long long timeUs = timeOf(METRIC_UTILIZATION);
+        advance(state.pcieRate.txBytesPerSec,
+                counterRate(state.pcieTx, sample.pcieTxBytes, timeUs, sample.pcieCounterRange));
+        advance(state.pcieRate.rxBytesPerSec,
+                counterRate(state.pcieRx, sample.pcieRxBytes, timeUs, sample.pcieCounterRange));
+
+        size_t links = sample.nvlinkLinkBytes.size();
+        state.nvlink.resize(links);
+        state.nvlinkRates.resize(links);
+        state.nvlinkRate = TrafficRate{};
+        for (size_t link = 0; link < links; link++) {
+            TrafficRate& rate = state.nvlinkRates[link];
+            advance(rate.txBytesPerSec, counterRate(state.nvlink[link][0], sample.nvlinkLinkBytes[link].txBytes,
+                                                    timeUs, sample.nvlinkCounterRange));
+            advance(rate.rxBytesPerSec, counterRate(state.nvlink[link][1], sample.nvlinkLinkBytes[link].rxBytes,
+                                                    timeUs, sample.nvlinkCounterRange));
+            state.nvlinkRate.txBytesPerSec += rate.txBytesPerSec;
+            state.nvlinkRate.rxBytesPerSec += rate.rxBytesPerSec;
         }
+    }
+    if (collectedGroups & (1u << METRIC_HEALTH)) {
+        advance(state.pcieReplayRate,
+                counterRate(state.pcieReplays, sample.pcieReplays, timeOf(METRIC_HEALTH), sample.pcieReplayRange));
+    }
+}
 
-        // Utilization
-        nvmlUtilization_t utilization;
-        if (nvmlDeviceGetUtilizationRates(device, &utilization) == NVML_SUCCESS) {
-            stats.gpuUtilization = utilization.gpu;
-            stats.memUtilization = utilization.memory;
-        }
+void GpuMonitor::buildDevices(unsigned int deviceCount) {
+    auto descriptors = m_backend->enumerateDevices();
+    m_devicesSkipped = descriptors.size() < deviceCount;
+    m_lastEnumeration = Clock::now();
+
+    // Devices are matched by UUID, so one that is still there keeps its readings, events
+    // and adaptive interval. One that is no longer enumerated stays in the table, marked
+    // gone, until it comes back or the monitor shuts down.
+    std::vector<DeviceState> devices = std::move(m_devices);
+    std::unordered_map<std::string, DeviceState*> known;
+    for (auto& state : devices) {
+        state.gone = true;
+        if (!state.descriptor->uuid.empty()) known.emplace(state.descriptor->uuid, &state);
+    }
 
-        // Temperature
-        unsigned int temp;
-        if (nvmlDeviceGetTemperature(device, NVML_TEMPERATURE_GPU, &temp) == NVML_SUCCESS) {
-            stats.temperature = temp;
+    std::vector<DeviceState> added;
+    for (size_t i = 0; i < descriptors.size(); i++) {
+        auto it = known.find(descriptors[i]->uuid);
+        if (it != known.end()) {
+            DeviceState& state = *it->second;
+            state.descriptor = std::move(descriptors[i]);
+            state.backendIndex = i;
+            state.gone = false;
+            known.erase(it);
+            continue;
         }
+        DeviceState state;
+        state.descriptor = std::move(descriptors[i]);
+        state.backendIndex = i;
+        added.push_back(std::move(state));
+    }
+    devices.insert(devices.end(), std::make_move_iterator(added.begin()), std::make_move_iterator(added.end()));
 
-        // Fan speed (may not be available on all GPUs)
-        unsigned int fan;
-        if (nvmlDeviceGetFanSpeed(device, &fan) == NVML_SUCCESS) {
-            stats.fanSpeed = fan;
-        }
+    // Sort by PCI bus ID (matches physical slot order when looking at hardware)
+    std::ranges::sort(devices, {}, [](const DeviceState& state) {
+        return state.descriptor->pciBusId;
+    });
 
-        // Power
-        unsigned int power;
-        if (nvmlDeviceGetPowerUsage(device, &power) == NVML_SUCCESS) {
-            stats.powerDraw = power / 1000;  // Convert mW to W
-        }
-        unsigned int limit;
-        if (nvmlDeviceGetPowerManagementLimit(device, &limit) == NVML_SUCCESS) {
-            stats.powerLimit = limit / 1000;  // Convert mW to W
-        }
+    m_devices = std::move(devices);
+    m_deviceCount = deviceCount;
+    m_rediscover = false;
+}
 
-        // Clocks (current and max)
-        unsigned int clock;
-        if (nvmlDeviceGetClockInfo(device, NVML_CLOCK_GRAPHICS, &clock) == NVML_SUCCESS) {
-            stats.gpuClock = clock;
-        }
-        if (nvmlDeviceGetMaxClockInfo(device, NVML_CLOCK_GRAPHICS, &clock) == NVML_SUCCESS) {
-            stats.gpuClockMax = clock;
+GpuStats GpuMonitor::collectDevice(DeviceState& state, unsigned int dueGroups, Clock::time_point now) {
+    // Groups that are not due keep their previous values in the merged sample; a device
+    // with nothing due is republished as it was. A device the backend reports lost keeps
+    // the readings from before it went.
+    GpuSample& sample = state.sample;
+    if (dueGroups != 0) {
+        CaptureTime captured = CaptureTime::now();
+        if (m_backend->collect(state.backendIndex, dueGroups, sample)) {
+            captured.durationUs = static_cast<unsigned int>(CaptureTime::now().steadyUs - captured.steadyUs);
+            sample.captured = captured;
+            for (int group = 0; group < METRIC_GROUP_COUNT; group++) {
+                if (dueGroups & (1u << group)) state.lastUpdate[group] = now;
+            }
+            adaptInterval(state, dueGroups);
+            updateRates(state, dueGroups);
+        } else {
+            state.gone = true;
+            dueGroups = 0;
         }
-        if (nvmlDeviceGetClockInfo(device, NVML_CLOCK_MEM, &clock) == NVML_SUCCESS) {
-            stats.memClock = clock;
+    }
+
+    // Backends that know their process names (simulated, replay) fill them in directly, and
+    // the NVML backend keeps them for PIDs it listed on the previous poll, so only new PIDs
+    // are resolved here.
+    // An exited process keeps the name cached while it ran, if it was seen running.
+    if (dueGroups & (1u << METRIC_PROCESSES)) {
+        for (auto& proc : sample.processes) {
+            if (proc.name.empty()) {
+                ProcessDetails details = m_processResolver.resolve(proc.pid);
+                proc.name = std::move(details.name);
+                proc.commandLine = std::move(details.commandLine);
+                proc.user = std::move(details.user);
+            }
         }
-        if (nvmlDeviceGetMaxClockInfo(device, NVML_CLOCK_MEM, &clock) == NVML_SUCCESS) {
-            stats.memClockMax = clock;
+        for (auto& proc : sample.exitedProcesses) {
+            if (proc.name.empty()) {
+                proc.name = m_processResolver.resolve(proc.pid).name;
+            }
         }
+    }
 
-        // PCIe info
-        unsigned int gen, width;
-        if (nvmlDeviceGetCurrPcieLinkGeneration(device, &gen) == NVML_SUCCESS) {
-            stats.pcieGen = gen;
-        }
-        if (nvmlDeviceGetCurrPcieLinkWidth(device, &width) == NVML_SUCCESS) {
-            stats.pcieWidth = width;
+    GpuStats stats{};
+    static_cast<GpuSample&>(stats) = sample;
+    stats.device = state.descriptor;
+    stats.events = state.events;
+    for (int group = 0; group < METRIC_GROUP_COUNT; group++) {
+        auto age = std::chrono::duration_cast<std::chrono::milliseconds>(now - state.lastUpdate[group]);
+        stats.groupAgeMs[group] = static_cast<unsigned int>(age.count());
+    }
+    stats.pollIntervalMs = static_cast<unsigned int>(groupPeriod(state, METRIC_UTILIZATION).count());
+    stats.gone = state.gone;
+    stats.pcieRate = state.pcieRate;
+    stats.pcieReplayRate = state.pcieReplayRate;
+    stats.nvlinkRate = state.nvlinkRate;
+    stats.nvlinkLinkRates = state.nvlinkRates;
+    return stats;
+}
+
+std::vector<unsigned int> GpuMonitor::drainEvents() {
+    std::vector<unsigned int> forcedGroups(m_devices.size());
+    if (!m_eventQueue) return forcedGroups;
+
+    // Each event refreshes the groups it invalidates on its own device on this tick instead
+    // of waiting for their period: ECC counters and link state after errors, clocks after
+    // a change. Events are matched by UUID, since a rebuilt device table holds new
+    // descriptors: an event raised before the rebuild (such as the XID of a GPU falling off
+    // the bus, the usual reason for one) still reaches the device that raised it.
+    DeviceEvent event;
+    while (m_eventQueue->pop(event)) {
+        auto it = std::ranges::find_if(m_devices, [&](const DeviceState& state) {
+            return state.descriptor == event.device ||
+                   (!event.device->uuid.empty() && state.descriptor->uuid == event.device->uuid);
+        });
+        if (it == m_devices.end()) continue;
+        size_t index = static_cast<size_t>(it - m_devices.begin());
+
+        if (event.event.type == EVENT_CLOCK_CHANGE) {
+            forcedGroups[index] |= 1u << METRIC_THERMAL;
+            continue;
         }
+        forcedGroups[index] |= 1u << METRIC_HEALTH;
 
-        // Running processes
-        nvmlProcessInfo_t processInfos[32];
-        unsigned int processCount = 32;
-        if (nvmlDeviceGetComputeRunningProcesses(device, &processCount, processInfos) == NVML_SUCCESS) {
-            for (unsigned int p = 0; p < processCount; p++) {
-                GpuProcess proc;
-                proc.pid = processInfos[p].pid;
-                proc.usedMemory = processInfos[p].usedGpuMemory;
-                proc.name = getProcessName(proc.pid, refreshProcessNames);
-                activePids.insert(proc.pid);
-                stats.processes.push_back(proc);
-            }
+        it->events.push_back(event.event);
+        if (it->events.size() > MAX_DEVICE_EVENTS) {
+            it->events.erase(it->events.begin());
         }
-        // Also get graphics processes (for WDDM mode)
-        processCount = 32;
-        if (nvmlDeviceGetGraphicsRunningProcesses(device, &processCount, processInfos) == NVML_SUCCESS) {
-            for (unsigned int p = 0; p < processCount; p++) {
-                // Avoid duplicates using std::ranges
-                unsigned int pid = processInfos[p].pid;
-                bool found = std::ranges::any_of(stats.processes, [pid](const auto& proc) {
-                    return proc.pid == pid;
-                });
-                if (!found) {
-                    GpuProcess proc;
-                    proc.pid = pid;
-                    proc.usedMemory = processInfos[p].usedGpuMemory;
-                    proc.name = getProcessName(proc.pid, refreshProcessNames);
-                    activePids.insert(proc.pid);
-                    stats.processes.push_back(proc);
-                }
-            }
+    }
+    return forcedGroups;
+}
+
+void GpuMonitor::updateStats() {
+    if (!m_initialized) return;
+
+    // Work out which metric groups are due on each device. A little slack keeps a group
+    // from slipping a whole tick late when the previous poll ran slightly long. Device
+    // events force the groups they invalidate on the device that raised them. Gone devices
+    // are not collected; with no live devices, the device count is checked every tick.
+    auto now = Clock::now();
+    CaptureTime captured = CaptureTime::now();
+    auto slack = tickInterval() / 2;
+    std::vector<unsigned int> due = drainEvents();
+    std::chrono::milliseconds healthPeriod(m_groupPeriodMs[METRIC_HEALTH].load(std::memory_order_relaxed));
+    bool reprobe = m_devicesSkipped && now - m_lastEnumeration + slack >= healthPeriod;
+    bool anyDue = m_rediscover || reprobe || std::ranges::all_of(m_devices, &DeviceState::gone);
+    for (size_t i = 0; i < m_devices.size(); i++) {
+        if (m_devices[i].gone) {
+            due[i] = 0;
+            continue;
         }
+        due[i] |= dueGroups(m_devices[i], now, slack);
+        anyDue |= due[i] != 0;
+    }
+    if (!anyDue) return;
 
-        // ECC errors
-        stats.eccSupported = false;
-        stats.eccErrors = 0;
-        nvmlEnableState_t eccMode;
-        if (nvmlDeviceGetEccMode(device, &eccMode, nullptr) == NVML_SUCCESS) {
-            stats.eccSupported = true;
-            if (eccMode == NVML_FEATURE_ENABLED) {
-                unsigned long long eccCount;
-                if (nvmlDeviceGetTotalEccErrors(device, NVML_MEMORY_ERROR_TYPE_CORRECTED,
-                    NVML_VOLATILE_ECC, &eccCount) == NVML_SUCCESS) {
-                    stats.eccErrors = eccCount;
-                }
-            }
+    unsigned int deviceCount = 0;
+    if (!m_backend->getDeviceCount(deviceCount)) return;
+
+    // Handles, static properties and topology are re-queried when the device count changes
+    // or a device was lost (which also covers one being swapped for another at the same
+    // count, as its UUID no longer matches). A device the backend skipped because its
+    // handle or UUID could not be read leaves the count unchanged, so while one is missing
+    // the devices are also enumerated again every health period. The backend's handles
+    // are all new, so every group is collected on every device right away.
+    if (m_rediscover || reprobe || deviceCount != m_deviceCount) {
+        buildDevices(deviceCount);
+        updateSystemInfo();
+        due.assign(m_devices.size(), 0);
+        for (size_t i = 0; i < m_devices.size(); i++) {
+            if (!m_devices[i].gone) due[i] = (1u << METRIC_GROUP_COUNT) - 1;
         }
+    }
 
-        newStats.push_back(stats);
+    // Size the worker pool to the requested count, but never wider than the device list
+    unsigned int workers = std::clamp<unsigned int>(
+        m_pollWorkers.load(std::memory_order_relaxed), 1u,
+        std::max<unsigned int>(1u, static_cast<unsigned int>(m_devices.size())));
+    if (!m_workerPool || m_workerPool->size() != workers) {
+        m_workerPool = std::make_unique<WorkerPool>(workers);
     }
 
-    // Sort by PCI bus ID (matches physical slot order when looking at hardware)
-    std::ranges::sort(newStats, {}, &GpuStats::pciBusId);
+    // Each device is collected independently into its own slot, which keeps the
+    // bus ID order of m_devices so the snapshot needs no sorting
+    std::vector<GpuStats> newStats(m_devices.size());
+    m_workerPool->run(m_devices.size(), [&](size_t i) {
+        newStats[i] = collectDevice(m_devices[i], due[i], now);
+    });
 
-    // Clean up stale process name cache entries (processes that no longer exist)
-    if (refreshProcessNames) {
-        std::erase_if(m_processNameCache, [&activePids](const auto& entry) {
-            return activePids.find(entry.first) == activePids.end();
-        });
+    // A device lost during this poll is enumerated away on the next one
+    for (size_t i = 0; i < m_devices.size(); i++) {
+        if (due[i] != 0 && m_devices[i].gone) m_rediscover = true;
     }
 
-    // Update shared stats
-    {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        m_stats = std::move(newStats);
+    // Forget processes that are no longer on any GPU
+    if (std::ranges::any_of(due, [](unsigned int groups) { return groups & (1u << METRIC_PROCESSES); })) {
+        std::unordered_set<unsigned int> activePids;
+        for (const auto& stats : newStats) {
+            for (const auto& proc : stats.processes) {
+                activePids.insert(proc.pid);
+            }
+        }
+        m_processResolver.retain(activePids);
+    }
+
+    m_systemInfo.nvmlCallsAvoided = m_backend->callsAvoided();
+    if (now - m_callLatencyUpdate >= std::chrono::seconds(1)) {
+        m_systemInfo.callLatency = std::make_shared<const std::vector<CallLatency>>(m_backend->callLatency());
+        m_callLatencyUpdate = now;
     }
+    captured.durationUs = static_cast<unsigned int>(CaptureTime::now().steadyUs - captured.steadyUs);
+    publish(std::move(newStats), captured);
 }
 
-std::vector<GpuStats> GpuMonitor::getStats() {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    return m_stats;
+void GpuMonitor::publish(std::vector<GpuStats> gpus, const CaptureTime& captured) {
+    auto snapshot = std::make_shared<GpuSnapshot>();
+    snapshot->generation = ++m_generation;
+    snapshot->captured = captured;
+    snapshot->gpus = std::move(gpus);
+    snapshot->system = m_systemInfo;
+
+    // The previous snapshot is released after the lock, and only freed once the last
+    // reader holding it lets go
+    std::shared_ptr<const GpuSnapshot> previous = snapshot;
+    {
+        std::lock_guard<std::mutex> lock(m_snapshotMutex);
+        m_snapshot.swap(previous);
+    }
+    if (m_snapshotListener) m_snapshotListener(std::move(snapshot));
 }
 
-SystemInfo GpuMonitor::getSystemInfo() {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    return m_systemInfo;
+void GpuMonitor::setSnapshotListener(SnapshotListener listener) {
+    m_snapshotListener = std::move(listener);
 }
 
-void GpuMonitor::updateSystemInfo() {
-    if (!m_initialized) return;
+std::shared_ptr<const GpuSnapshot> GpuMonitor::getSnapshot() const {
+    std::lock_guard<std::mutex> lock(m_snapshotMutex);
+    return m_snapshot;
+}
 
-    SystemInfo info;
+std::vector<CallLatency> GpuMonitor::getCallLatency() const {
+    return m_backend->callLatency();
+}
 
-    // Driver version
-    char driverVersion[NVML_SYSTEM_DRIVER_VERSION_BUFFER_SIZE];
-    if (nvmlSystemGetDriverVersion(driverVersion, sizeof(driverVersion)) == NVML_SUCCESS) {
-        info.driverVersion = driverVersion;
-    }
+std::vector<GpuStats> GpuMonitor::getStats() const {
+    return getSnapshot()->gpus;
+}
 
-    // CUDA version (NVML reports as int like 12090 for 12.9)
-    int cudaVersion;
-    if (nvmlSystemGetCudaDriverVersion(&cudaVersion) == NVML_SUCCESS) {
-        int major = cudaVersion / 1000;
-        int minor = (cudaVersion % 1000) / 10;
-        info.cudaVersion = std::to_string(major) + "." + std::to_string(minor);
-    }
+SystemInfo GpuMonitor::getSystemInfo() const {
+    return getSnapshot()->system;
+}
 
-    // NVLink status - check connections between GPUs
-    info.nvlinkAvailable = false;
-    unsigned int deviceCount = 0;
-    if (nvmlDeviceGetCount(&deviceCount) == NVML_SUCCESS) {
-        for (unsigned int i = 0; i < deviceCount; i++) {
-            nvmlDevice_t device;
-            if (nvmlDeviceGetHandleByIndex(i, &device) != NVML_SUCCESS) continue;
-
-            // Check each NVLink link (up to 6 links per GPU)
-            for (unsigned int link = 0; link < 6; link++) {
-                nvmlEnableState_t isActive;
-                if (nvmlDeviceGetNvLinkState(device, link, &isActive) == NVML_SUCCESS) {
-                    if (isActive == NVML_FEATURE_ENABLED) {
-                        info.nvlinkAvailable = true;
-
-                        // Get remote GPU info
-                        nvmlPciInfo_t remotePci;
-                        if (nvmlDeviceGetNvLinkRemotePciInfo(device, link, &remotePci) == NVML_SUCCESS) {
-                            // Find which GPU index this connects to
-                            for (unsigned int j = 0; j < deviceCount; j++) {
-                                if (j == i) continue;
-                                nvmlDevice_t otherDevice;
-                                if (nvmlDeviceGetHandleByIndex(j, &otherDevice) != NVML_SUCCESS) continue;
-                                nvmlPciInfo_t otherPci;
-                                if (nvmlDeviceGetPciInfo(otherDevice, &otherPci) == NVML_SUCCESS) {
-                                    if (strcmp(remotePci.busId, otherPci.busId) == 0) {
-                                        // Found a connection
-                                        auto pair = std::make_pair(
-                                            static_cast<int>(std::min(i, j)),
-                                            static_cast<int>(std::max(i, j)));
-                                        // Avoid duplicates
-                                        if (std::find(info.nvlinkPairs.begin(), info.nvlinkPairs.end(), pair) == info.nvlinkPairs.end()) {
-                                            info.nvlinkPairs.push_back(pair);
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-    }
+void GpuMonitor::updateSystemInfo() {
+    if (!m_initialized) return;
 
-    std::lock_guard<std::mutex> lock(m_mutex);
-    m_systemInfo = info;
+    SystemInfo info{};
+    info.backendName = m_backend->name();
+    m_backend->querySystemInfo(info);
+    info.nvmlCallsAvoided = m_backend->callsAvoided();
+    info.poll = m_systemInfo.poll;
+    info.callLatency = m_systemInfo.callLatency;
+    m_systemInfo = std::move(info);
 }
 
-void GpuMonitor::startPolling(int intervalMs) {
+void GpuMonitor::startPolling(int tickMs) {
     if (m_pollThread.joinable()) return;
 
-    m_pollIntervalMs = intervalMs;
+    // The queue exists before either thread so the poll thread never sees it change
+    bool events = m_initialized && m_backend->supportsEvents();
+    if (events && !m_eventQueue) {
+        m_eventQueue = std::make_unique<SpscQueue<DeviceEvent, 256>>();
+    }
+
+    m_pollIntervalMs.store(std::max(tickMs, 1), std::memory_order_relaxed);
+    m_systemInfo.poll = PollStats{};
     m_pollThread = std::jthread([this](std::stop_token stopToken) {
         pollThread(stopToken);
     });
+    if (events) {
+        m_eventThread = std::jthread([this](std::stop_token stopToken) {
+            eventThread(stopToken);
+        });
+    }
 }
 
 void GpuMonitor::stopPolling() {
+    // The event thread stops first so nothing wakes a poll thread that is going away
+    if (m_eventThread.joinable()) {
+        m_eventThread.request_stop();
+        m_eventThread = std::jthread{};
+    }
     if (m_pollThread.joinable()) {
         m_pollThread.request_stop();
         // jthread auto-joins on destruction, but we want immediate stop
@@ -332,14 +531,78 @@ void GpuMonitor::stopPolling() {
 }
 
 void GpuMonitor::pollThread(std::stop_token stopToken) {
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+    auto interval = [this] { return tickInterval(); };
+    auto toUs = [](Clock::duration d) {
+        return static_cast<unsigned int>(std::max<long long>(0, duration_cast<microseconds>(d).count()));
+    };
+
+    // Ticks run on a grid of absolute deadlines, so the time spent polling does not add
+    // to the period and the schedule does not drift
+    Clock::time_point tick = Clock::now();
+    unsigned long long jitterTotalUs = 0;
     while (!stopToken.stop_requested()) {
+        PollStats& stats = m_systemInfo.poll;
+        auto start = Clock::now();
+        stats.intervalMs = static_cast<unsigned int>(interval().count());
+        stats.ticks++;
+        stats.jitterLastUs = toUs(start - tick);
+        stats.jitterMaxUs = std::max(stats.jitterMaxUs, stats.jitterLastUs);
+        jitterTotalUs += stats.jitterLastUs;
+        stats.jitterMeanUs = static_cast<unsigned int>(jitterTotalUs / stats.ticks);
+
         updateStats();
 
-        // Sleep in small increments to allow quick shutdown
-        int slept = 0;
-        while (slept < m_pollIntervalMs && !stopToken.stop_requested()) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            slept += 100;
+        auto end = Clock::now();
+        stats.pollLastUs = toUs(end - start);
+        stats.pollMaxUs = std::max(stats.pollMaxUs, stats.pollLastUs);
+
+        // A poll that ran past the next deadline skips the missed ticks instead of
+        // running them back to back
+        Clock::time_point next = tick + interval();
+        if (next <= end) {
+            auto missed = (end - tick) / interval();
+            stats.overruns++;
+            stats.missedTicks += static_cast<unsigned long long>(missed) - 1;
+            next = tick + interval() * (missed + 1);
+        }
+
+        // Sleep until the deadline or shutdown. A device event polls in between without
+        // moving the grid; an interval change re-plans the deadline from the last tick.
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        while (m_wakeCv.wait_until(lock, stopToken, next,
+                                   [this] { return m_wakeRequested || m_intervalChanged; })) {
+            if (m_intervalChanged) {
+                m_intervalChanged = false;
+                next = std::max(tick + interval(), Clock::now());
+                continue;
+            }
+            m_wakeRequested = false;
+            lock.unlock();
+            updateStats();
+            lock.lock();
+        }
+        tick = next;
+    }
+}
+
+void GpuMonitor::eventThread(std::stop_token stopToken) {
+    // Short waits so shutdown is not held up by a quiet driver
+    constexpr unsigned int WAIT_MS = 100;
+
+    while (!stopToken.stop_requested()) {
+        DeviceEvent event;
+        if (!m_backend->waitForEvent(WAIT_MS, event)) continue;
+
+        // Clock changes can arrive in bursts and are picked up on the next tick;
+        // errors wake the poll thread so they are published within milliseconds
+        bool critical = event.event.type != EVENT_CLOCK_CHANGE;
+        if (!m_eventQueue->push(std::move(event)) || !critical) continue;
+        {
+            std::lock_guard<std::mutex> lock(m_wakeMutex);
+            m_wakeRequested = true;
         }
+        m_wakeCv.notify_one();
     }
 }
@@ -1,36 +1,292 @@
 #pragma once
 
-#include <map>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
 #include <mutex>
+#include <optional>
 #include <stop_token>
 #include <string>
 #include <thread>
 #include <vector>
 
+#include "platform/process_resolver.h"
+
 // Process running on a GPU
 struct GpuProcess {
     unsigned int pid;
     std::string name;
+    std::string commandLine;        // Full command line (Windows: image path)
+    std::string user;               // Owning user
     unsigned long long usedMemory;  // bytes
-    // Note: per-process GPU utilization not available via NVML
+
+    // Utilization attributed to this process, 0-100% averaged since the previous poll
+    unsigned int smUtil = 0;
+    unsigned int memUtil = 0;
+    unsigned int encUtil = 0;
+    unsigned int decUtil = 0;
+};
+
+// Process that ran on a GPU and has since exited, from the driver's accounting records.
+// Requires accounting mode (`nvidia-smi -am 1`); catches processes that start and exit
+// between two polls.
+struct ExitedProcess {
+    unsigned int pid;
+    std::string name;               // "Unknown" if it exited before it was seen running
+    long long startTimeUs;          // Microseconds since the Unix epoch
+    unsigned long long durationMs;  // Lifetime
+    unsigned long long maxMemory;   // bytes (peak)
+    unsigned int gpuUtil;           // 0-100%, averaged over the lifetime
+    unsigned int memUtil;           // 0-100%, averaged over the lifetime
+};
+
+// Exited processes kept per GPU
+constexpr size_t MAX_EXITED_PROCESSES = 32;
+
+// Process running on a MIG instance. Name and command line are on the parent GPU's
+// entry for the same PID.
+struct MigProcess {
+    unsigned int pid;
+    unsigned long long usedMemory;  // bytes, on this instance
+};
+
+// GPU Performance Monitoring metrics (Hopper and later), averaged over the interval
+// between the two most recent driver samples. Percentages are 0-100.
+struct GpmMetrics {
+    bool valid;                      // False without GPM support, or before the second sample
+    double smActivity;               // Time SMs had at least one warp resident
+    double smOccupancy;              // Resident warps relative to the SMs' maximum
+    double tensorActivity;           // Time any tensor pipe was busy
+    double dramBandwidth;            // DRAM bandwidth used relative to the peak
+    double pcieTxBytesPerSec;
+    double pcieRxBytesPerSec;
+    double nvlinkTxBytesPerSec;      // Summed over all links
+    double nvlinkRxBytesPerSec;
+};
+
+// MIG device (a compute instance inside a GPU instance) carved out of a GPU
+struct MigInstance {
+    std::string uuid;                // "MIG-..." UUID, as CUDA_VISIBLE_DEVICES takes it
+    std::string name;                // Profile name, e.g. "NVIDIA A100-SXM4-80GB MIG 3g.40gb"
+    unsigned int index;              // MIG device index on the parent
+    unsigned int gpuInstanceId;
+    unsigned int computeInstanceId;
+    unsigned int smCount;            // Streaming multiprocessors
+    unsigned long long vramUsed;     // bytes
+    unsigned long long vramTotal;    // bytes
+    std::vector<MigProcess> processes;
+    GpmMetrics gpm;                  // Of the GPU instance (shared by its compute instances)
+};
+
+// Poll scheduler timing since polling started
+struct PollStats {
+    unsigned int intervalMs;           // Current tick interval
+    unsigned long long ticks;          // Scheduled ticks run
+    unsigned long long overruns;       // Ticks whose poll ran past the next deadline
+    unsigned long long missedTicks;    // Deadlines skipped because of overruns
+    unsigned int jitterLastUs;         // Wake-up lateness relative to the deadline
+    unsigned int jitterMaxUs;
+    unsigned int jitterMeanUs;
+    unsigned int pollLastUs;           // Time spent collecting in a tick
+    unsigned int pollMaxUs;
+};
+
+// Latency of one driver entry point on one device, since the monitor started. Slow
+// calls are often the first sign of a degrading GPU.
+struct CallLatency {
+    const char* function;        // Entry point name (static string)
+    std::string deviceUuid;      // Empty for system-wide calls (init, device count, ...)
+    unsigned long long calls;
+    unsigned long long errors;   // Failures other than expected results such as "not supported"
+    unsigned long long p50Us;
+    unsigned long long p99Us;
+    unsigned long long maxUs;
+};
+
+// Closest point two GPUs share in the PCIe tree (nvidia-smi topo -m: PIX, PXB, PHB, NODE, SYS)
+enum TopologyLevel {
+    TOPO_UNKNOWN,
+    TOPO_SAME_BOARD,         // Multi-GPU board
+    TOPO_PCIE_SWITCH,        // Behind one PCIe switch
+    TOPO_PCIE_SWITCHES,      // Across several PCIe switches, without the host bridge
+    TOPO_HOST_BRIDGE,        // Same host bridge
+    TOPO_NUMA_NODE,          // Different host bridges on one NUMA node
+    TOPO_SYSTEM              // Across NUMA nodes (CPU interconnect)
+};
+
+// How one GPU reaches another
+struct GpuPeerLink {
+    TopologyLevel level{TOPO_UNKNOWN};
+    bool p2pRead{false};         // Peer-to-peer access supported by driver and chipset
+    bool p2pWrite{false};
+    bool p2pAtomics{false};
+    bool p2pNvlink{false};       // Peer traffic can use NVLink (directly or via NVSwitch)
+    unsigned int nvlinkCount{0};    // Active links that end at the other GPU
+    unsigned int nvlinkVersion{0};  // As reported by the driver for those links (0 if none)
+};
+
+// Interconnect between every pair of GPUs, queried when devices are enumerated
+struct GpuTopology {
+    std::vector<unsigned int> cudaIndices;  // Row/column order
+    std::vector<GpuPeerLink> links;         // Row-major cudaIndices.size()^2; diagonal unused
+
+    const GpuPeerLink& link(size_t row, size_t column) const {
+        return links[row * cudaIndices.size() + column];
+    }
 };
 
 // System-wide GPU info
 struct SystemInfo {
+    std::string backendName;   // Data source ("NVML", "Simulated", "Replay")
     std::string driverVersion;
     std::string cudaVersion;
     bool nvlinkAvailable;
     std::vector<std::pair<int, int>> nvlinkPairs;  // pairs of connected GPU indices
+
+    // Full pairwise topology (null if the backend cannot tell). Shared between snapshots.
+    std::shared_ptr<const GpuTopology> topology;
+    unsigned long long nvmlCallsAvoided;  // Calls skipped by handle/capability caching
+    PollStats poll;                       // As of the previous tick
+
+    // Driver call latency per function and device, refreshed about once a second
+    // (null if the backend does not time its calls). Shared between snapshots.
+    std::shared_ptr<const std::vector<CallLatency>> callLatency;
 };
 
-struct GpuStats {
+// Static per-device properties, queried once and shared by every published sample.
+// Rebuilt only when the device count changes.
+struct GpuDescriptor {
     std::string name;
     std::string uuid;          // Unique GPU identifier (for settings key)
     std::string pciBusId;      // Physical slot (for default sort order)
     bool isTCC;
-    bool persistenceMode;      // Linux: whether persistence mode is enabled
     unsigned int cudaIndex;    // CUDA device index
 
+    // Clocks
+    unsigned int gpuClockMax;      // MHz (max)
+    unsigned int memClockMax;      // MHz (max)
+
+    // ECC (mode changes require a reboot)
+    bool eccSupported;
+    bool eccEnabled;
+
+    unsigned int nvlinkLinks;      // Number of NVLink links (0 if none)
+};
+
+// Metric groups polled on independent periods. Fast-moving values are refreshed often;
+// values that rarely change are refreshed rarely.
+enum MetricGroup {
+    METRIC_UTILIZATION,  // Utilization, power draw, PCIe/NVLink counters (default 100 ms)
+    METRIC_THERMAL,      // Temperatures, fan speed, current clocks (default 500 ms)
+    METRIC_PROCESSES,    // VRAM usage, running processes (default 1 s)
+    METRIC_HEALTH,       // ECC, PCIe link/replays, persistence, power limit (default 30 s)
+    METRIC_GROUP_COUNT
+};
+
+// One entry from the driver's internal sample buffer
+struct TimedValue {
+    long long timestampUs;  // Microseconds since the Unix epoch
+    float value;
+};
+
+// High-resolution traces captured between polls (nvmlDeviceGetSamples)
+enum SampleTrace {
+    TRACE_GPU_UTILIZATION,  // 0-100%  (utilization group)
+    TRACE_MEM_UTILIZATION,  // 0-100%  (utilization group)
+    TRACE_POWER,            // Watts   (utilization group)
+    TRACE_GPU_CLOCK,        // MHz     (thermal group)
+    TRACE_MEM_CLOCK,        // MHz     (thermal group)
+    TRACE_COUNT
+};
+
+// Asynchronous device events reported by the driver between polls
+enum GpuEventType {
+    EVENT_XID,            // Critical error; data = XID code
+    EVENT_ECC_SINGLE_BIT, // Correctable ECC error
+    EVENT_ECC_DOUBLE_BIT, // Uncorrectable ECC error
+    EVENT_CLOCK_CHANGE,   // Clocks or performance state changed (not kept in GpuStats::events)
+};
+
+struct GpuEvent {
+    long long timestampUs;     // Microseconds since the Unix epoch, when the event arrived
+    GpuEventType type;
+    unsigned long long data;   // Event-specific payload (XID code)
+};
+
+// When a piece of data was captured. The steady time is for ages and intervals within
+// this process; the wall time is for display and export.
+struct CaptureTime {
+    long long steadyUs{0};         // steady_clock, microseconds
+    long long wallUs{0};           // Microseconds since the Unix epoch
+    unsigned int durationUs{0};    // Time spent querying the driver for it
+
+    // Current steady and wall time, with no duration
+    static CaptureTime now();
+};
+
+// Bytes moved over a link in each direction
+struct LinkTraffic {
+    unsigned long long txBytes;
+    unsigned long long rxBytes;
+};
+
+// Throughput over a link in each direction
+struct TrafficRate {
+    double txBytesPerSec{0.0};
+    double rxBytesPerSec{0.0};
+};
+
+// Why the core clock is below its maximum: NVML's clocks event reason bits (named
+// "throttle reasons" before R535). Several can be active at once.
+enum ClockEventReason : unsigned long long {
+    CLOCK_EVENT_IDLE           = 0x001,  // Nothing running
+    CLOCK_EVENT_APP_CLOCKS     = 0x002,  // Held at the application clocks setting
+    CLOCK_EVENT_SW_POWER_CAP   = 0x004,
+    CLOCK_EVENT_HW_SLOWDOWN    = 0x008,  // Hardware slowdown (over-temperature, power brake)
+    CLOCK_EVENT_SYNC_BOOST     = 0x010,  // Matched to the slowest GPU of a sync boost group
+    CLOCK_EVENT_SW_THERMAL     = 0x020,
+    CLOCK_EVENT_HW_THERMAL     = 0x040,
+    CLOCK_EVENT_HW_POWER_BRAKE = 0x080,
+    CLOCK_EVENT_DISPLAY_CLOCK  = 0x100,
+};
+
+// Throttle causes the driver keeps cumulative time counters for. Also groups the
+// ClockEventReason bits for display.
+enum ThrottleCause {
+    THROTTLE_POWER,        // Software power cap
+    THROTTLE_THERMAL,      // Software or hardware thermal slowdown
+    THROTTLE_HW_SLOWDOWN,  // Hardware slowdown and power brake (reason bits only, no counter)
+    THROTTLE_BOARD_LIMIT,  // Board limits (counter only, no reason bit)
+    THROTTLE_SYNC_BOOST,
+    THROTTLE_IDLE,         // Low utilization
+    THROTTLE_CAUSE_COUNT
+};
+
+// ClockEventReason bits that count towards a cause
+constexpr unsigned long long throttleCauseReasons(ThrottleCause cause) {
+    switch (cause) {
+        case THROTTLE_POWER:       return CLOCK_EVENT_SW_POWER_CAP;
+        case THROTTLE_THERMAL:     return CLOCK_EVENT_SW_THERMAL | CLOCK_EVENT_HW_THERMAL;
+        case THROTTLE_HW_SLOWDOWN: return CLOCK_EVENT_HW_SLOWDOWN | CLOCK_EVENT_HW_POWER_BRAKE;
+        case THROTTLE_SYNC_BOOST:  return CLOCK_EVENT_SYNC_BOOST;
+        case THROTTLE_IDLE:        return CLOCK_EVENT_IDLE;
+        default:                   return 0;
+    }
+}
+
+// Theoretical PCIe throughput per direction in bytes/s at a link generation and width,
+// after line encoding (0 for an unknown generation)
+double pcieBandwidth(unsigned int gen, unsigned int width);
+
+// Dynamic per-poll values
+struct GpuSample {
+    CaptureTime captured;      // Latest collect of this device (any group)
+
+    bool persistenceMode;      // Linux: whether persistence mode is enabled
+
     // Memory
     unsigned long long vramUsed;   // bytes
     unsigned long long vramTotal;  // bytes
@@ -39,63 +295,264 @@ struct GpuStats {
     unsigned int gpuUtilization;   // 0-100%
     unsigned int memUtilization;   // 0-100%
 
+    // Profiling metrics (utilization group; with MIG enabled they are per instance only)
+    GpmMetrics gpm;
+
     // Thermals & Power
     unsigned int temperature;      // Celsius
+    unsigned int memTemperature;   // Celsius (HBM boards only, 0 if not reported)
     unsigned int fanSpeed;         // 0-100%
-    unsigned int powerDraw;        // Watts
+    unsigned int powerDraw;        // Watts (rounded down; see powerDrawMw)
+    unsigned int powerDrawMw;      // Milliwatts
+    unsigned long long energyMj;   // Cumulative since driver load, millijoules (0 if not reported)
     unsigned int powerLimit;       // Watts
 
     // Clocks
     unsigned int gpuClock;         // MHz (current)
-    unsigned int gpuClockMax;      // MHz (max)
     unsigned int memClock;         // MHz (current)
-    unsigned int memClockMax;      // MHz (max)
+    unsigned long long clockEventReasons;  // ClockEventReason bits at the last read
+
+    // Cumulative time the clock was held back per ThrottleCause, in nanoseconds since
+    // driver load (0 when the driver does not report the cause)
+    std::array<unsigned long long, THROTTLE_CAUSE_COUNT> throttleTimeNs;
 
     // PCIe
     unsigned int pcieGen;          // 1-4
     unsigned int pcieWidth;        // lanes (e.g., 16)
 
+    // Interconnect activity counters (monotonic since driver load)
+    unsigned long long pcieTxBytes;
+    unsigned long long pcieRxBytes;
+    unsigned long long pcieReplays;    // Link-level retransmissions
+    unsigned long long nvlinkTxBytes;  // Summed over all links
+    unsigned long long nvlinkRxBytes;
+    std::vector<LinkTraffic> nvlinkLinkBytes;  // Per link, by link number
+    // Value at which the counters above wrap to 0, when the driver reports them as 32-bit
+    // values (0: they use the full 64-bit range)
+    unsigned long long pcieCounterRange;    // Both PCIe byte counters
+    unsigned long long pcieReplayRange;
+    unsigned long long nvlinkCounterRange;  // Every link's byte counters
+
+    // Driver samples newer than the previous read of their group, oldest first.
+    // Consumers should skip entries at or before the last timestamp they have seen, since
+    // a group that is not due keeps its previous trace.
+    std::array<std::vector<TimedValue>, TRACE_COUNT> traces;
+
     // Processes
     std::vector<GpuProcess> processes;
 
+    // MIG mode and the instances configured on the GPU (health group; empty when MIG is
+    // off). Instance memory and processes are refreshed with the processes group.
+    bool migEnabled;
+    std::vector<MigInstance> migInstances;
+
+    // Recently exited processes, oldest first. Backends append exits as they learn of
+    // them (process group) and drop the oldest past MAX_EXITED_PROCESSES.
+    std::vector<ExitedProcess> exitedProcesses;
+
     // ECC Errors
     unsigned long long eccErrors;  // total correctable errors
-    bool eccSupported;
+
+    // Driver timestamp (microseconds since epoch) of each group's batched field values.
+    // 0 when the group was read through individual queries instead.
+    std::array<long long, METRIC_GROUP_COUNT> fieldTimestampUs;
 };
 
+// Published per-GPU view: latest value of every metric group plus the device's
+// static descriptor
+struct GpuStats : GpuSample {
+    std::shared_ptr<const GpuDescriptor> device;
+    std::array<unsigned int, METRIC_GROUP_COUNT> groupAgeMs;  // Age of each group at publish
+    unsigned int pollIntervalMs;   // Current utilization period for this device (see setAdaptivePolling)
+    bool gone;                     // Lost or unplugged; the readings are the last ones taken
+
+    // Interconnect throughput from the counters' change between their two latest reads.
+    // Zero until the second read, and for an interval in which a counter was reset.
+    TrafficRate pcieRate;
+    double pcieReplayRate;                // Replays per second
+    TrafficRate nvlinkRate;               // All links
+    std::vector<TrafficRate> nvlinkLinkRates;
+
+    // Most recent XID and ECC events on this device, oldest first
+    std::vector<GpuEvent> events;
+};
+
+// Everything the monitor publishes, as one immutable unit. A new snapshot replaces the
+// previous one after every poll that collected something; readers hold on to theirs for
+// as long as they need it, without copying.
+struct GpuSnapshot {
+    unsigned long long generation{0};  // Increments with every publish
+    CaptureTime captured;              // Start of the poll; duration covers all devices
+    std::vector<GpuStats> gpus;        // Sorted by PCI bus ID
+    SystemInfo system{};
+};
+
+template <typename T, size_t Capacity> class SpscQueue;
+class GpuBackend;
+class WorkerPool;
+struct DeviceEvent;
+
 class GpuMonitor {
 public:
-    GpuMonitor();
+    GpuMonitor();  // NVML backend
+    explicit GpuMonitor(std::unique_ptr<GpuBackend> backend);
     ~GpuMonitor();
 
     bool initialize();
     void shutdown();
 
-    // Get a copy of current GPU stats (thread-safe)
-    std::vector<GpuStats> getStats();
+    // Latest published snapshot (never null). Only the pointer is copied, so readers
+    // never wait on a poll or copy stats; compare `generation` to tell whether anything changed.
+    std::shared_ptr<const GpuSnapshot> getSnapshot() const;
 
-    // Get system-wide info (driver, CUDA version, NVLink)
-    SystemInfo getSystemInfo();
+    // Called with every snapshot as it is published, on the thread that polled it (the
+    // poll thread, or the caller of initialize() for the first). It runs between polls, so
+    // it should hand the snapshot off rather than work on it. Set before initialize().
+    using SnapshotListener = std::function<void(std::shared_ptr<const GpuSnapshot>)>;
+    void setSnapshotListener(SnapshotListener listener);
 
-    // Start/stop background polling
-    void startPolling(int intervalMs = 1000);
+    // Copies of the latest GPU stats and system-wide info (driver, CUDA version, NVLink)
+    std::vector<GpuStats> getStats() const;
+    SystemInfo getSystemInfo() const;
+
+    // Start/stop background polling. The tick is the scheduler resolution; each metric
+    // group is collected on the first tick after its own period has elapsed.
+    void startPolling(int tickMs = 100);
     void stopPolling();
 
+    // Change the scheduler tick while polling. The next deadline is re-planned from the
+    // last tick right away, so a shorter interval takes effect immediately.
+    void setPollInterval(int tickMs);
+
+    // Change how often a metric group is collected (takes effect on the next tick)
+    void setMetricGroupPeriod(MetricGroup group, int periodMs);
+
+    // Adaptive polling: each device's poll interval (the period of its utilization group)
+    // moves between minMs and maxMs. It drops to the minimum when the device's utilization,
+    // power or process list changes, doubles on every poll that finds the device idle, and
+    // holds while it is busy but steady. Slower groups keep their own period but are never
+    // collected more often than the device interval. Off by default.
+    void setAdaptivePolling(bool enabled, int minMs = 50, int maxMs = 2000);
+
+    // Driver call latency as of now (see SystemInfo::callLatency for the copy published
+    // with each snapshot). Safe to call from any thread.
+    std::vector<CallLatency> getCallLatency() const;
+
+    // Number of threads (including the poll thread) that query devices in parallel.
+    // Capped at the device count; takes effect on the next poll.
+    void setPollWorkers(unsigned int count);
+
 private:
+    using Clock = std::chrono::steady_clock;
+
+    // One read of a monotonic counter, with the time it was taken (wall clock)
+    struct CounterReading {
+        unsigned long long value{0};
+        long long timeUs{0};
+    };
+
+    // Per-device state, cached across polls
+    struct DeviceState {
+        std::shared_ptr<const GpuDescriptor> descriptor;
+        size_t backendIndex{0};              // Device index in the backend's enumeration
+        GpuSample sample{};                  // Latest value of every metric group
+        std::array<Clock::time_point, METRIC_GROUP_COUNT> lastUpdate{};
+        std::vector<GpuEvent> events;        // Bounded by MAX_DEVICE_EVENTS
+        bool gone{false};                    // No longer enumerated; kept with its last readings
+
+        // Adaptive polling: current interval (0 = not adapting) and the readings it was
+        // last compared against
+        int intervalMs{0};
+        unsigned int activityUtil{0};
+        unsigned int activityPower{0};
+        unsigned long long processSignature{0};
+
+        // Previous interconnect counter readings and the rates derived from them
+        CounterReading pcieTx, pcieRx, pcieReplays;
+        std::vector<std::array<CounterReading, 2>> nvlink;  // TX, RX per link
+        TrafficRate pcieRate;
+        double pcieReplayRate{0.0};
+        TrafficRate nvlinkRate;
+        std::vector<TrafficRate> nvlinkRates;
+    };
+
+    static constexpr size_t MAX_DEVICE_EVENTS = 16;
+
     void pollThread(std::stop_token stopToken);
+    void eventThread(std::stop_token stopToken);
+    // Queued device events into m_devices; returns the groups each device must refresh now
+    std::vector<unsigned int> drainEvents();
     void updateStats();
     void updateSystemInfo();
-    std::string getProcessName(unsigned int pid, bool forceRefresh = false);
+    void publish(std::vector<GpuStats> gpus, const CaptureTime& captured);
+    void buildDevices(unsigned int deviceCount);
+
+    // Scheduler tick; tighter than the configured interval when adaptive polling needs it
+    std::chrono::milliseconds tickInterval() const;
+
+    // Period of a metric group on one device, and the groups due on it now
+    std::chrono::milliseconds groupPeriod(const DeviceState& state, int group) const;
+    unsigned int dueGroups(const DeviceState& state, Clock::time_point now, Clock::duration slack) const;
+
+    // Move a device's adaptive interval after it was collected
+    void adaptInterval(DeviceState& state, unsigned int collectedGroups);
+
+    // Turn the interconnect counters of the groups just collected into rates
+    void updateRates(DeviceState& state, unsigned int collectedGroups);
+
+    // Per-second rate of a counter since `previous`, which the reading then replaces.
+    // Empty when the reading is no newer than `previous`.
+    static std::optional<double> counterRate(CounterReading& previous, unsigned long long value, long long timeUs,
+                                             unsigned long long range);
+
+    GpuStats collectDevice(DeviceState& state, unsigned int dueGroups, Clock::time_point now);
+
+    std::unique_ptr<GpuBackend> m_backend;
+
+    // Published state. The lock only covers copying or swapping the pointer; snapshots are
+    // built and freed outside it. m_systemInfo is the poller's working copy.
+    std::shared_ptr<const GpuSnapshot> m_snapshot{std::make_shared<const GpuSnapshot>()};
+    mutable std::mutex m_snapshotMutex;
+    unsigned long long m_generation{0};
+    SystemInfo m_systemInfo{};
+    SnapshotListener m_snapshotListener;
+
+    // Device table (owned by the poll thread once polling starts), sorted by PCI bus ID.
+    // Devices are enumerated again when the backend's count changes or a device is lost,
+    // and every health period while the backend skipped a device it could not read.
+    std::vector<DeviceState> m_devices;
+    unsigned int m_deviceCount{0};
+    bool m_rediscover{true};
+    bool m_devicesSkipped{false};        // Fewer devices enumerated than the backend counts
+    Clock::time_point m_lastEnumeration{};
+
+    // Parallel per-device collection
+    std::atomic<unsigned int> m_pollWorkers{4};
+    std::unique_ptr<WorkerPool> m_workerPool;
 
-    std::vector<GpuStats> m_stats;
-    SystemInfo m_systemInfo;
-    std::mutex m_mutex;
     std::jthread m_pollThread;
-    int m_pollIntervalMs{1000};
+    std::atomic<int> m_pollIntervalMs{100};  // Scheduler tick
+
+    // Device events: the event thread blocks in the backend and hands events to the poll
+    // thread through a lock-free queue, then wakes it so they are published right away
+    std::unique_ptr<SpscQueue<DeviceEvent, 256>> m_eventQueue;
+    std::jthread m_eventThread;
+    std::mutex m_wakeMutex;
+    std::condition_variable_any m_wakeCv;
+    bool m_wakeRequested{false};     // Poll now (device event)
+    bool m_intervalChanged{false};   // Re-plan the next deadline
+
+    // Tiered schedule: period per MetricGroup (when each device last collected a group
+    // is in DeviceState::lastUpdate)
+    std::array<std::atomic<int>, METRIC_GROUP_COUNT> m_groupPeriodMs{100, 500, 1000, 30000};
+
+    // Adaptive polling bounds (see setAdaptivePolling)
+    std::atomic<bool> m_adaptive{false};
+    std::atomic<int> m_adaptiveMinMs{50};
+    std::atomic<int> m_adaptiveMaxMs{2000};
+    Clock::time_point m_callLatencyUpdate{};  // When SystemInfo::callLatency was last refreshed
     bool m_initialized{false};
 
-    // Process name caching - only refresh names every N polls to reduce syscalls
-    int m_processNameUpdateInterval{5};  // Refresh process names every N polls
-    int m_pollsSinceProcessNameUpdate{0};
-    std::map<unsigned int, std::string> m_processNameCache;  // PID -> name
+    // PID -> name, command line and user; shared by the device workers
+    ProcessResolver m_processResolver;
 };
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+
+// Log-linear histogram of durations in microseconds, HDR-style: values are grouped by
+// power of two, and each power is split into 8 linear sub-buckets, so any percentile is
+// reported within 12.5% of the recorded value. Memory is fixed (240 counters) and
+// record() is a handful of relaxed atomic operations, so it is cheap enough to wrap every
+// driver call and safe to read while another thread records.
+class LatencyHistogram {
+public:
+    void record(unsigned long long us) {
+        us = std::min<unsigned long long>(us, MAX_VALUE);
+        m_counts[bucketOf(us)].fetch_add(1, std::memory_order_relaxed);
+        m_count.fetch_add(1, std::memory_order_relaxed);
+        unsigned long long max = m_max.load(std::memory_order_relaxed);
+        while (us > max && !m_max.compare_exchange_weak(max, us, std::memory_order_relaxed)) {
+        }
+    }
+
+    unsigned long long count() const { return m_count.load(std::memory_order_relaxed); }
+    unsigned long long max() const { return m_max.load(std::memory_order_relaxed); }
+
+    // Upper bound of the bucket holding the given percentile (0-100), capped at the
+    // largest value recorded. 0 when nothing was recorded.
+    unsigned long long percentile(double p) const {
+        unsigned long long total = count();
+        if (total == 0) return 0;
+
+        auto rank = static_cast<unsigned long long>(p / 100.0 * static_cast<double>(total) + 0.5);
+        rank = std::clamp<unsigned long long>(rank, 1, total);
+        unsigned long long seen = 0;
+        for (size_t bucket = 0; bucket < BUCKET_COUNT; bucket++) {
+            seen += m_counts[bucket].load(std::memory_order_relaxed);
+            if (seen >= rank) return std::min(upperBound(bucket), max());
+        }
+        return max();  // Counts raced ahead of the total; the maximum is still an upper bound
+    }
+
+private:
+    static constexpr unsigned int SUB_BUCKET_BITS = 3;
+    static constexpr unsigned long long SUB_BUCKETS = 1ull << SUB_BUCKET_BITS;
+    static constexpr unsigned long long MAX_VALUE = (1ull << 32) - 1;  // ~71 minutes
+    static constexpr size_t BUCKET_COUNT = SUB_BUCKETS + (32 - SUB_BUCKET_BITS) * SUB_BUCKETS;
+
+    // Values below SUB_BUCKETS get a bucket each; above that, the top SUB_BUCKET_BITS + 1
+    // bits of the value pick the bucket
+    static size_t bucketOf(unsigned long long us) {
+        if (us < SUB_BUCKETS) return static_cast<size_t>(us);
+        unsigned int shift = static_cast<unsigned int>(std::bit_width(us)) - 1 - SUB_BUCKET_BITS;
+        return static_cast<size_t>(SUB_BUCKETS * (shift + 1) + ((us >> shift) - SUB_BUCKETS));
+    }
+
+    static unsigned long long upperBound(size_t bucket) {
+        if (bucket < SUB_BUCKETS) return bucket;
+        unsigned long long shift = bucket / SUB_BUCKETS - 1;
+        unsigned long long sub = bucket % SUB_BUCKETS + SUB_BUCKETS;
+        return ((sub + 1) << shift) - 1;
+    }
+
+    std::array<std::atomic<unsigned long long>, BUCKET_COUNT> m_counts{};
+    std::atomic<unsigned long long> m_count{0};
+    std::atomic<unsigned long long> m_max{0};
+};
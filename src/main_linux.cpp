@@ -1,4 +1,6 @@
 #include "gpu_monitor.h"
+#include "backend/gpu_backend.h"
+#include "backend/replay_backend.h"
 #include "ui.h"
 
 #include "imgui.h"
@@ -9,6 +11,7 @@
 
 #include <GLFW/glfw3.h>
 #include <cstdio>
+#include <cstring>
 #include <thread>
 #include <chrono>
 
@@ -16,7 +19,26 @@ static void glfw_error_callback(int error, const char* description) {
     fprintf(stderr, "GLFW Error %d: %s\n", error, description);
 }
 
-int main(int /*argc*/, char** /*argv*/) {
+int main(int argc, char** argv) {
+    // Data source: NVML by default, --simulate / --replay for machines without a GPU
+    std::string backendError;
+    auto backend = createBackend(argc, argv, backendError);
+    if (!backend) {
+        fprintf(stderr, "%s\n", backendError.c_str());
+        return 1;
+    }
+    const char* backendName = backend->name();
+
+    // --record=FILE: every published snapshot is written out for --replay
+    std::unique_ptr<ReplayRecorder> recorder;
+    if (std::string path = recordingPath(argc, argv); !path.empty()) {
+        recorder = std::make_unique<ReplayRecorder>(path);
+        if (!recorder->isOpen()) {
+            fprintf(stderr, "Cannot write recording to %s\n", path.c_str());
+            return 1;
+        }
+    }
+
     glfwSetErrorCallback(glfw_error_callback);
     if (!glfwInit()) {
         return 1;
@@ -67,12 +89,18 @@ int main(int /*argc*/, char** /*argv*/) {
     ImGui_ImplOpenGL3_Init(glsl_version);
 
     // Initialize GPU monitoring
-    GpuMonitor gpuMonitor;
+    GpuMonitor gpuMonitor(std::move(backend));
+    if (recorder) {
+        gpuMonitor.setSnapshotListener([&recorder](std::shared_ptr<const GpuSnapshot> snapshot) {
+            recorder->enqueue(std::move(snapshot));
+        });
+    }
     if (!gpuMonitor.initialize()) {
-        fprintf(stderr, "Failed to initialize NVML. Make sure NVIDIA drivers are installed.\n");
+        fprintf(stderr, "Failed to initialize %s backend.%s\n", backendName,
+                strcmp(backendName, "NVML") == 0 ? " Make sure NVIDIA drivers are installed." : "");
         // Continue anyway - will show empty state
     }
-    gpuMonitor.startPolling(1000);  // 1 second interval
+    gpuMonitor.startPolling();  // Each metric group runs on its own period
 
     // Create UI renderer
     GpuMonitorUI ui;
@@ -93,9 +121,9 @@ int main(int /*argc*/, char** /*argv*/) {
         ImGui::NewFrame();
 
         // Render our UI
-        auto stats = gpuMonitor.getStats();
-        auto sysInfo = gpuMonitor.getSystemInfo();
-        ui.render(stats, sysInfo);
+        // Held for the frame; the poller publishes a new snapshot rather than changing this one
+        auto snapshot = gpuMonitor.getSnapshot();
+        ui.render(snapshot->gpus, snapshot->system);
 
         // Rendering
         ImGui::Render();
@@ -1,4 +1,6 @@
 #include "gpu_monitor.h"
+#include "backend/gpu_backend.h"
+#include "backend/replay_backend.h"
 #include "ui.h"
 
 #include "imgui.h"
@@ -8,6 +10,8 @@
 #include "fa_solid_900_compressed.h"
 
 #include <d3d11.h>
+#include <cstring>
+#include <stdlib.h>
 #include <tchar.h>
 #include <wrl/client.h>
 
@@ -33,6 +37,25 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
     (void)hPrevInstance;
     (void)lpCmdLine;
 
+    // Data source: NVML by default, --simulate / --replay for machines without a GPU
+    std::string backendError;
+    auto backend = createBackend(__argc, __argv, backendError);
+    if (!backend) {
+        MessageBoxA(nullptr, backendError.c_str(), "GPU Monitor Error", MB_ICONERROR);
+        return 1;
+    }
+    bool nvmlBackend = strcmp(backend->name(), "NVML") == 0;
+
+    // --record=FILE: every published snapshot is written out for --replay
+    std::unique_ptr<ReplayRecorder> recorder;
+    if (std::string path = recordingPath(__argc, __argv); !path.empty()) {
+        recorder = std::make_unique<ReplayRecorder>(path);
+        if (!recorder->isOpen()) {
+            MessageBoxA(nullptr, ("Cannot write recording to " + path).c_str(), "GPU Monitor Error", MB_ICONERROR);
+            return 1;
+        }
+    }
+
     // Create application window (C++20 designated initializers)
     WNDCLASSEX wc = {
         .cbSize = sizeof(WNDCLASSEX),
@@ -102,13 +125,20 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
     ImGui_ImplDX11_Init(g_pd3dDevice.Get(), g_pd3dDeviceContext.Get());
 
     // Initialize GPU monitoring
-    GpuMonitor gpuMonitor;
+    GpuMonitor gpuMonitor(std::move(backend));
+    if (recorder) {
+        gpuMonitor.setSnapshotListener([&recorder](std::shared_ptr<const GpuSnapshot> snapshot) {
+            recorder->enqueue(std::move(snapshot));
+        });
+    }
     if (!gpuMonitor.initialize()) {
-        MessageBox(hwnd, _T("Failed to initialize NVML. Make sure NVIDIA drivers are installed."),
+        MessageBox(hwnd, nvmlBackend
+                       ? _T("Failed to initialize NVML. Make sure NVIDIA drivers are installed.")
+                       : _T("Failed to initialize the selected GPU data source."),
                    _T("GPU Monitor Error"), MB_ICONERROR);
         // Continue anyway - will show empty state
     }
-    gpuMonitor.startPolling(1000);  // 1 second interval
+    gpuMonitor.startPolling();  // Each metric group runs on its own period
 
     // Create UI renderer
     GpuMonitorUI ui;
@@ -135,9 +165,9 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
         ImGui::NewFrame();
 
         // Render our UI
-        auto stats = gpuMonitor.getStats();
-        auto sysInfo = gpuMonitor.getSystemInfo();
-        ui.render(stats, sysInfo);
+        // Held for the frame; the poller publishes a new snapshot rather than changing this one
+        auto snapshot = gpuMonitor.getSnapshot();
+        ui.render(snapshot->gpus, snapshot->system);
 
         // Rendering
         ImGui::Render();
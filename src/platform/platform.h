@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include <cstddef>
 
 namespace Platform {
@@ -37,10 +38,6 @@ std::string normalizeCommand(const std::string& cmd);
 // Returns true on success
 bool killProcess(unsigned int pid);
 
-// Get the name of a process by PID
-// Returns "Unknown" if the process cannot be found
-std::string getProcessName(unsigned int pid);
-
 // Open a folder browser dialog
 // Returns the selected path, or empty string if cancelled
 std::string browseForFolder(const std::string& title = "");
@@ -48,4 +45,17 @@ std::string browseForFolder(const std::string& title = "");
 // Safe string copy (cross-platform replacement for strncpy_s)
 void safeCopy(char* dest, size_t destSize, const char* src);
 
+// Load a shared library (dlopen / LoadLibrary)
+// Returns nullptr if it cannot be loaded
+void* openLibrary(const std::string& path);
+
+// Look up an exported symbol in a library returned by openLibrary
+// Returns nullptr if the symbol does not exist
+void* findSymbol(void* library, const char* name);
+
+// Default NVML library paths to try, in order
+// Windows: nvml.dll (System32), then the NVSMI folder
+// Linux: libnvidia-ml.so.1
+std::vector<std::string> nvmlLibraryCandidates();
+
 } // namespace Platform
@@ -2,7 +2,7 @@
 
 #include <cstdlib>
 #include <cstring>
-#include <fstream>
+#include <dlfcn.h>
 #include <signal.h>
 #include <unistd.h>
 #include <sys/types.h>
@@ -99,19 +99,6 @@ bool killProcess(unsigned int pid) {
     return kill(static_cast<pid_t>(pid), SIGTERM) == 0;
 }
 
-std::string getProcessName(unsigned int pid) {
-    std::string commPath = "/proc/" + std::to_string(pid) + "/comm";
-    std::ifstream file(commPath);
-    if (file.is_open()) {
-        std::string name;
-        std::getline(file, name);
-        if (!name.empty()) {
-            return name;
-        }
-    }
-    return "Unknown";
-}
-
 std::string browseForFolder(const std::string& title) {
     // Try zenity first (GTK)
     std::string cmd = "zenity --file-selection --directory";
@@ -170,4 +157,17 @@ void safeCopy(char* dest, size_t destSize, const char* src) {
     }
 }
 
+void* openLibrary(const std::string& path) {
+    return dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+}
+
+void* findSymbol(void* library, const char* name) {
+    return library ? dlsym(library, name) : nullptr;
+}
+
+std::vector<std::string> nvmlLibraryCandidates() {
+    // The unversioned .so only ships with driver development packages
+    return { "libnvidia-ml.so.1", "libnvidia-ml.so" };
+}
+
 } // namespace Platform
@@ -102,29 +102,6 @@ bool killProcess(unsigned int pid) {
     return false;
 }
 
-std::string getProcessName(unsigned int pid) {
-    HANDLE hProcess = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, pid);
-    if (!hProcess) {
-        return "Unknown";
-    }
-
-    char processName[MAX_PATH] = "";
-    DWORD size = MAX_PATH;
-    if (QueryFullProcessImageNameA(hProcess, 0, processName, &size)) {
-        CloseHandle(hProcess);
-        // Extract just the filename
-        std::string fullPath(processName);
-        size_t pos = fullPath.find_last_of("\\/");
-        if (pos != std::string::npos) {
-            return fullPath.substr(pos + 1);
-        }
-        return fullPath;
-    }
-
-    CloseHandle(hProcess);
-    return "Unknown";
-}
-
 std::string browseForFolder(const std::string& title) {
     BROWSEINFOA bi = {};
     bi.lpszTitle = title.empty() ? "Select Folder" : title.c_str();
@@ -149,4 +126,25 @@ void safeCopy(char* dest, size_t destSize, const char* src) {
     }
 }
 
+void* openLibrary(const std::string& path) {
+    return reinterpret_cast<void*>(LoadLibraryA(path.c_str()));
+}
+
+void* findSymbol(void* library, const char* name) {
+    if (!library) return nullptr;
+    return reinterpret_cast<void*>(GetProcAddress(static_cast<HMODULE>(library), name));
+}
+
+std::vector<std::string> nvmlLibraryCandidates() {
+    std::vector<std::string> candidates = { "nvml.dll" };
+
+    // Older drivers install NVML next to nvidia-smi instead of System32
+    char programFiles[MAX_PATH];
+    DWORD len = GetEnvironmentVariableA("ProgramW6432", programFiles, MAX_PATH);
+    if (len > 0 && len < MAX_PATH) {
+        candidates.push_back(std::string(programFiles) + "\\NVIDIA Corporation\\NVSMI\\nvml.dll");
+    }
+    return candidates;
+}
+
 } // namespace Platform
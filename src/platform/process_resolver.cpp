@@ -0,0 +1,99 @@
+#include "platform/process_resolver.h"
+
+#include <algorithm>
+#include <bit>
+#include <functional>
+
+// Platform-independent half: the PID-keyed cache. The reads live in
+// process_resolver_linux.cpp / process_resolver_win32.cpp.
+
+ProcessDetails ProcessResolver::resolve(unsigned int pid) {
+    // Unchanged stamp: the cached process is still the one using the PID
+    unsigned long long processStamp = stamp(pid);
+    if (processStamp != 0) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Entry* entry = find(pid);
+        if (entry && entry->stamp == processStamp) return entry->details;
+    }
+
+    unsigned long long start = startTime(pid);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Entry* entry = find(pid);
+        if (entry && (entry->startTime == start || start == 0)) {
+            // Same process, or gone: last known details
+            if (start != 0) entry->stamp = processStamp;
+            return entry->details;
+        }
+    }
+
+    // New PID or reused PID: read outside the lock so other lookups are not held up
+    Entry entry;
+    entry.pid = pid;
+    entry.stamp = processStamp;
+    entry.startTime = start;
+    if (start != 0) {
+        entry.details = readDetails(pid);
+    }
+    if (entry.details.name.empty()) {
+        entry.details.name = "Unknown";
+    }
+
+    ProcessDetails details = entry.details;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (Entry* existing = find(pid)) {
+        *existing = std::move(entry);
+    } else {
+        insert(std::move(entry));
+    }
+    return details;
+}
+
+void ProcessResolver::retain(const std::unordered_set<unsigned int>& active) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Open addressing has no cheap erase; rebuild from the survivors instead
+    std::vector<Entry> entries = std::move(m_entries);
+    m_entries.clear();
+    m_count = 0;
+    rehash(std::max<size_t>(16, std::bit_ceil(active.size() * 2)));
+    for (auto& entry : entries) {
+        if (entry.pid != 0 && active.contains(entry.pid)) {
+            insert(std::move(entry));
+        }
+    }
+}
+
+ProcessResolver::Entry* ProcessResolver::find(unsigned int pid) {
+    if (m_entries.empty()) return nullptr;
+
+    size_t mask = m_entries.size() - 1;
+    for (size_t i = std::hash<unsigned int>{}(pid) & mask;; i = (i + 1) & mask) {
+        if (m_entries[i].pid == pid) return &m_entries[i];
+        if (m_entries[i].pid == 0) return nullptr;
+    }
+}
+
+void ProcessResolver::insert(Entry entry) {
+    // Keep the table at most half full so probe runs stay short
+    if ((m_count + 1) * 2 > m_entries.size()) {
+        rehash(std::max<size_t>(16, m_entries.size() * 2));
+    }
+
+    size_t mask = m_entries.size() - 1;
+    size_t i = std::hash<unsigned int>{}(entry.pid) & mask;
+    while (m_entries[i].pid != 0) {
+        i = (i + 1) & mask;
+    }
+    m_entries[i] = std::move(entry);
+    m_count++;
+}
+
+void ProcessResolver::rehash(size_t capacity) {
+    std::vector<Entry> old = std::move(m_entries);
+    m_entries.assign(capacity, Entry{});
+    m_count = 0;
+    for (auto& entry : old) {
+        if (entry.pid != 0) insert(std::move(entry));
+    }
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// What is known about a running process
+struct ProcessDetails {
+    std::string name;         // Short name ("Unknown" if the process cannot be found)
+    std::string commandLine;  // Full command line, arguments separated by spaces
+    std::string user;         // Owning user (numeric ID if the account has no name)
+};
+
+// Cached PID -> process details lookup that is safe against PID reuse. Every lookup
+// first compares a cheap identity stamp of the process (on Linux, one stat of
+// /proc/<pid> with no file opened or read); only when that differs is the start time
+// read, and the rest is resolved again only when the start time changed too, i.e.
+// when the PID now belongs to a different process.
+// Thread-safe; lookups for different PIDs do their reads outside the lock.
+class ProcessResolver {
+public:
+    // Linux reads `procRoot` (normally /proc; point it at a fake tree for testing)
+    explicit ProcessResolver(const std::string& procRoot = "/proc");
+    ~ProcessResolver();
+
+    ProcessResolver(const ProcessResolver&) = delete;
+    ProcessResolver& operator=(const ProcessResolver&) = delete;
+
+    // Details of the process currently using `pid`. If the process has exited, the last
+    // details cached for the PID are returned (name "Unknown" if it was never resolved).
+    ProcessDetails resolve(unsigned int pid);
+
+    // Forget every PID not in `active`
+    void retain(const std::unordered_set<unsigned int>& active);
+
+    // Per-process reads done so far (procfs files on Linux, process handles opened on
+    // Windows); cached lookups add none. Used by the resolver benchmark.
+    unsigned long long reads() const { return m_reads.load(std::memory_order_relaxed); }
+
+private:
+    // Cache slot in an open-addressed table keyed by PID (0 marks an empty slot;
+    // PID 0 is never a user process)
+    struct Entry {
+        unsigned int pid{0};
+        unsigned long long stamp{0};
+        unsigned long long startTime{0};
+        ProcessDetails details;
+    };
+
+    // Platform reads. stamp() is a value that changes whenever the PID is taken by a new
+    // process (it may also change spuriously, which only costs a start time read); 0
+    // when the process does not exist or the platform has no cheap check. startTime()
+    // returns 0 when the process does not exist.
+    unsigned long long stamp(unsigned int pid) const;
+    unsigned long long startTime(unsigned int pid) const;
+    ProcessDetails readDetails(unsigned int pid);
+
+    Entry* find(unsigned int pid);
+    void insert(Entry entry);
+    void rehash(size_t capacity);
+
+    std::mutex m_mutex;
+    std::vector<Entry> m_entries;  // Power-of-two size, linear probing
+    size_t m_count{0};
+    mutable std::atomic<unsigned long long> m_reads{0};
+
+#ifndef _WIN32
+    std::string userName(unsigned int uid);
+
+    int m_procFd{-1};  // Open directory handle on the procfs root, reused for every read
+    std::unordered_map<unsigned int, std::string> m_userNames;  // uid -> name
+#endif
+};
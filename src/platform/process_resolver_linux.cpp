@@ -0,0 +1,132 @@
+#include "platform/process_resolver.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <pwd.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+// Read a small procfs file relative to the root directory into `buffer` and
+// NUL-terminate it. Returns the number of bytes read (0 if the file cannot be read).
+size_t readProcFile(int procFd, unsigned int pid, const char* file, char* buffer, size_t size) {
+    if (procFd < 0 || size == 0) return 0;
+
+    char path[64];
+    snprintf(path, sizeof(path), "%u/%s", pid, file);
+    int fd = openat(procFd, path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return 0;
+
+    size_t total = 0;
+    while (total + 1 < size) {
+        ssize_t n = read(fd, buffer + total, size - 1 - total);
+        if (n <= 0) break;
+        total += static_cast<size_t>(n);
+    }
+    close(fd);
+    buffer[total] = '\0';
+    return total;
+}
+
+// /proc/<pid>/stat is "pid (comm) state ppid ...". comm may itself contain spaces and
+// parentheses, so fields are counted from the last ')'. Returns a pointer to the text
+// after it, and the name between the first '(' and that ')'.
+const char* splitStat(char* stat, std::string* name) {
+    char* open = strchr(stat, '(');
+    char* close = strrchr(stat, ')');
+    if (!open || !close || close < open) return nullptr;
+    if (name) name->assign(open + 1, close);
+    return close + 1;
+}
+
+} // namespace
+
+ProcessResolver::ProcessResolver(const std::string& procRoot)
+    : m_procFd(open(procRoot.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC)) {
+}
+
+ProcessResolver::~ProcessResolver() {
+    if (m_procFd >= 0) close(m_procFd);
+}
+
+unsigned long long ProcessResolver::stamp(unsigned int pid) const {
+    // procfs gives each /proc/<pid> inode a fresh number and its creation time, so a new
+    // process on the same PID never matches the old stamp. The inode can be recreated
+    // for the same process after cache eviction, which only costs a start time read.
+    char dir[16];
+    snprintf(dir, sizeof(dir), "%u", pid);
+    struct stat info;
+    if (m_procFd < 0 || fstatat(m_procFd, dir, &info, 0) != 0) return 0;
+
+    unsigned long long changed = static_cast<unsigned long long>(info.st_ctim.tv_sec) * 1000000000ull +
+                                 static_cast<unsigned long long>(info.st_ctim.tv_nsec);
+    return (static_cast<unsigned long long>(info.st_ino) * 0x9E3779B97F4A7C15ull) ^ changed;
+}
+
+unsigned long long ProcessResolver::startTime(unsigned int pid) const {
+    char stat[512];
+    m_reads.fetch_add(1, std::memory_order_relaxed);
+    if (readProcFile(m_procFd, pid, "stat", stat, sizeof(stat)) == 0) return 0;
+
+    // starttime is field 22 overall, the 20th after the comm field
+    const char* fields = splitStat(stat, nullptr);
+    if (!fields) return 0;
+    for (int field = 0; field < 19; field++) {
+        fields = strchr(fields + 1, ' ');
+        if (!fields) return 0;
+    }
+    return std::strtoull(fields + 1, nullptr, 10);
+}
+
+ProcessDetails ProcessResolver::readDetails(unsigned int pid) {
+    ProcessDetails details;
+
+    // Short name comes from the same stat file (no separate comm read)
+    m_reads.fetch_add(3, std::memory_order_relaxed);
+    char stat[512];
+    if (readProcFile(m_procFd, pid, "stat", stat, sizeof(stat)) > 0) {
+        splitStat(stat, &details.name);
+    }
+
+    // Arguments are NUL-separated; longer command lines are truncated
+    char cmdline[4096];
+    size_t length = readProcFile(m_procFd, pid, "cmdline", cmdline, sizeof(cmdline));
+    while (length > 0 && cmdline[length - 1] == '\0') length--;
+    for (size_t i = 0; i < length; i++) {
+        if (cmdline[i] == '\0') cmdline[i] = ' ';
+    }
+    details.commandLine.assign(cmdline, length);
+
+    // The real user is the first Uid: field of status. The owner of /proc/<pid> is the
+    // effective uid instead, and root for any process that is not dumpable.
+    char status[2048];
+    if (readProcFile(m_procFd, pid, "status", status, sizeof(status)) > 0) {
+        if (const char* uid = strstr(status, "\nUid:")) {
+            details.user = userName(static_cast<unsigned int>(std::strtoul(uid + 5, nullptr, 10)));
+        }
+    }
+    return details;
+}
+
+std::string ProcessResolver::userName(unsigned int uid) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_userNames.find(uid);
+        if (it != m_userNames.end()) return it->second;
+    }
+
+    std::string name = std::to_string(uid);
+    char buffer[1024];
+    struct passwd entry;
+    struct passwd* result = nullptr;
+    if (getpwuid_r(uid, &entry, buffer, sizeof(buffer), &result) == 0 && result) {
+        name = result->pw_name;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_userNames[uid] = name;
+    return name;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// Bounded single-producer/single-consumer ring. push() and pop() never block or take a
+// lock, so a producer stuck in a driver call cannot stall the consumer and vice versa.
+// Capacity must be a power of two; one slot is kept free to tell full from empty.
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "SpscQueue capacity must be a power of two");
+
+public:
+    // Producer side. Returns false (and drops the value) when the queue is full.
+    bool push(T value) {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        size_t next = (tail + 1) & (Capacity - 1);
+        if (next == m_head.load(std::memory_order_acquire)) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        m_slots[tail] = std::move(value);
+        m_tail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Returns false when the queue is empty.
+    bool pop(T& value) {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire)) return false;
+        value = std::move(m_slots[head]);
+        m_slots[head] = T{};  // Release anything the value owns now rather than on reuse
+        m_head.store((head + 1) & (Capacity - 1), std::memory_order_release);
+        return true;
+    }
+
+    // Values discarded because the consumer fell behind
+    unsigned long long dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    std::array<T, Capacity> m_slots{};
+    alignas(64) std::atomic<size_t> m_head{0};  // Next slot to read (consumer)
+    alignas(64) std::atomic<size_t> m_tail{0};  // Next slot to write (producer)
+    std::atomic<unsigned long long> m_dropped{0};
+};
@@ -4,6 +4,7 @@
 #include "imgui_internal.h"
 #include "IconsFontAwesome6.h"
 #include <ranges>
+#include <chrono>
 #include <cstdio>
 #include <fstream>
 #include <sstream>
@@ -399,20 +400,25 @@ GpuConfig* GpuMonitorUI::getOrCreateGpuConfig(const std::string& uuid) {
 }
 
 std::string GpuMonitorUI::getGpuDisplayName(const GpuStats& stats) {
-    GpuConfig* config = getGpuConfig(stats.uuid);
+    GpuConfig* config = getGpuConfig(stats.device->uuid);
     if (config && !config->nickname.empty()) {
         return config->nickname;
     }
     // Default: use CUDA index
-    return "GPU " + std::to_string(stats.cudaIndex);
+    return "GPU " + std::to_string(stats.device->cudaIndex);
 }
 
-std::vector<GpuStats> GpuMonitorUI::sortGpusByUserOrder(const std::vector<GpuStats>& gpuStats) {
-    std::vector<GpuStats> sorted = gpuStats;
+std::vector<const GpuStats*> GpuMonitorUI::sortGpusByUserOrder(const std::vector<GpuStats>& gpuStats) {
+    // Sorts pointers into the snapshot; the stats themselves are never copied
+    std::vector<const GpuStats*> sorted;
+    sorted.reserve(gpuStats.size());
+    for (const auto& stats : gpuStats) {
+        sorted.push_back(&stats);
+    }
 
-    std::ranges::sort(sorted, [this](const GpuStats& a, const GpuStats& b) {
-        GpuConfig* configA = getGpuConfig(a.uuid);
-        GpuConfig* configB = getGpuConfig(b.uuid);
+    std::ranges::sort(sorted, [this](const GpuStats* a, const GpuStats* b) {
+        GpuConfig* configA = getGpuConfig(a->device->uuid);
+        GpuConfig* configB = getGpuConfig(b->device->uuid);
 
         int orderA = (configA && configA->displayOrder >= 0) ? configA->displayOrder : 1000;
         int orderB = (configB && configB->displayOrder >= 0) ? configB->displayOrder : 1000;
@@ -423,7 +429,7 @@ std::vector<GpuStats> GpuMonitorUI::sortGpusByUserOrder(const std::vector<GpuSta
         }
 
         // Fall back to bus ID order (default)
-        return a.pciBusId < b.pciBusId;
+        return a->device->pciBusId < b->device->pciBusId;
     });
 
     return sorted;
@@ -449,7 +455,7 @@ void GpuMonitorUI::renderDragHandle(const GpuStats& stats, const std::string& di
     }
 
     // Invisible button for drag interaction
-    ImGui::InvisibleButton(("##drag_" + stats.uuid).c_str(), ImVec2(20, 18));
+    ImGui::InvisibleButton(("##drag_" + stats.device->uuid).c_str(), ImVec2(20, 18));
 
     // Hover tooltip
     if (ImGui::IsItemHovered()) {
@@ -462,11 +468,11 @@ void GpuMonitorUI::renderDragHandle(const GpuStats& stats, const std::string& di
     // Drag source
     if (ImGui::BeginDragDropSource(ImGuiDragDropFlags_None)) {
         m_dragState.isDragging = true;
-        m_dragState.draggedUuid = stats.uuid;
+        m_dragState.draggedUuid = stats.device->uuid;
         m_dragState.dragSourceIndex = index;
 
-        ImGui::SetDragDropPayload("GPU_REORDER", stats.uuid.c_str(), stats.uuid.size() + 1);
-        ImGui::Text("Moving: %s (cuda:%u)", displayName.c_str(), stats.cudaIndex);
+        ImGui::SetDragDropPayload("GPU_REORDER", stats.device->uuid.c_str(), stats.device->uuid.size() + 1);
+        ImGui::Text("Moving: %s (cuda:%u)", displayName.c_str(), stats.device->cudaIndex);
         ImGui::EndDragDropSource();
     }
 }
@@ -517,20 +523,20 @@ void GpuMonitorUI::renderDropIndicator(int targetIndex) {
     );
 }
 
-void GpuMonitorUI::commitReorder(int sourceIndex, int targetIndex, const std::vector<GpuStats>& sortedStats) {
+void GpuMonitorUI::commitReorder(int sourceIndex, int targetIndex, const std::vector<const GpuStats*>& sortedStats) {
     if (sourceIndex == targetIndex || sourceIndex < 0 || targetIndex < 0) return;
     if (sourceIndex >= static_cast<int>(sortedStats.size())) return;
     if (targetIndex >= static_cast<int>(sortedStats.size())) return;
 
     // Ensure all GPUs have explicit display orders
     for (size_t i = 0; i < sortedStats.size(); i++) {
-        GpuConfig* config = getOrCreateGpuConfig(sortedStats[i].uuid);
+        GpuConfig* config = getOrCreateGpuConfig(sortedStats[i]->device->uuid);
         if (config) config->displayOrder = static_cast<int>(i);
     }
 
     // Get configs for source and target
-    GpuConfig* sourceConfig = getGpuConfig(sortedStats[sourceIndex].uuid);
-    GpuConfig* targetConfig = getGpuConfig(sortedStats[targetIndex].uuid);
+    GpuConfig* sourceConfig = getGpuConfig(sortedStats[sourceIndex]->device->uuid);
+    GpuConfig* targetConfig = getGpuConfig(sortedStats[targetIndex]->device->uuid);
 
     if (sourceConfig && targetConfig) {
         // Swap display orders
@@ -549,9 +555,9 @@ void GpuMonitorUI::commitReorder(int sourceIndex, int targetIndex, const std::ve
 std::string GpuMonitorUI::buildExcludeDevices(const std::vector<GpuStats>& allStats, unsigned int excludeIndex) {
     std::string result;
     for (const auto& gpu : allStats) {
-        if (gpu.cudaIndex != excludeIndex) {
+        if (gpu.device->cudaIndex != excludeIndex) {
             if (!result.empty()) result += ",";
-            result += std::to_string(gpu.cudaIndex);
+            result += std::to_string(gpu.device->cudaIndex);
         }
     }
     return result;
@@ -561,9 +567,9 @@ std::string GpuMonitorUI::buildNvlinkPair(const std::vector<GpuStats>& allStats)
     // Return all TCC (compute) GPUs - these are typically the NVLink-capable ones
     std::string result;
     for (const auto& gpu : allStats) {
-        if (gpu.isTCC) {
+        if (gpu.device->isTCC) {
             if (!result.empty()) result += ",";
-            result += std::to_string(gpu.cudaIndex);
+            result += std::to_string(gpu.device->cudaIndex);
         }
     }
     return result;
@@ -632,35 +638,127 @@ void GpuMonitorUI::renderModalOverlay() {
     // while greying out non-interactive sections
 }
 
-void GpuMonitorUI::renderCompactMetrics(const GpuStats& stats) {
-    // Calculate fractions
-    float powerFrac = stats.powerLimit > 0 ? static_cast<float>(stats.powerDraw) / stats.powerLimit : 0.0f;
-    float coreClockFrac = stats.gpuClockMax > 0 ? static_cast<float>(stats.gpuClock) / stats.gpuClockMax : 0.0f;
-    float memClockFrac = stats.memClockMax > 0 ? static_cast<float>(stats.memClock) / stats.memClockMax : 0.0f;
+// Throttle causes for display, most severe first: the clock timeline strip shows the
+// first active one
+struct ThrottleCauseStyle {
+    ThrottleCause cause;
+    const char* name;
+    ImU32 color;
+};
+static const ThrottleCauseStyle THROTTLE_CAUSE_STYLES[] = {
+    {THROTTLE_THERMAL,     "Thermal",     IM_COL32(240, 80, 80, 255)},
+    {THROTTLE_HW_SLOWDOWN, "HW slowdown", IM_COL32(220, 90, 220, 255)},
+    {THROTTLE_BOARD_LIMIT, "Board limit", IM_COL32(60, 190, 170, 255)},
+    {THROTTLE_POWER,       "Power cap",   IM_COL32(240, 170, 50, 255)},
+    {THROTTLE_SYNC_BOOST,  "Sync boost",  IM_COL32(90, 150, 240, 255)},
+    {THROTTLE_IDLE,        "Idle",        IM_COL32(110, 110, 120, 255)},
+};
+
+// Strip color for a set of ClockEventReason bits (0 = clock not held back)
+static ImU32 throttleColor(unsigned long long reasons) {
+    for (const auto& style : THROTTLE_CAUSE_STYLES) {
+        if (reasons & throttleCauseReasons(style.cause)) return style.color;
+    }
+    return 0;
+}
 
-    // Get history (already updated by renderGpuCard)
-    GpuMetricHistory& history = m_metricHistory[stats.uuid];
+// Energy for display: joules and kilowatt-hours
+static void formatEnergy(char* text, size_t size, double joules) {
+    snprintf(text, size, "%.1f J (%.4f kWh)", joules, joules / 3.6e6);
+}
+
+// Core clock tooltip: what limits the clock now and the driver's totals per cause
+static std::string throttleDetail(const GpuStats& stats) {
+    std::string detail;
+    for (const auto& style : THROTTLE_CAUSE_STYLES) {
+        if (stats.clockEventReasons & throttleCauseReasons(style.cause)) {
+            detail += detail.empty() ? "Limited by: " : ", ";
+            detail += style.name;
+        }
+    }
+    if (detail.empty()) detail = "Not limited";
+
+    bool header = false;
+    for (const auto& style : THROTTLE_CAUSE_STYLES) {
+        unsigned long long ns = stats.throttleTimeNs[style.cause];
+        if (ns == 0) continue;
+        if (!header) {
+            detail += "\nSince driver load:";
+            header = true;
+        }
+        char line[64];
+        snprintf(line, sizeof(line), "\n  %s: %.1f s", style.name, ns / 1e9);
+        detail += line;
+    }
+    detail += "\nStrip: red thermal, magenta HW slowdown, amber power,\nblue sync boost, gray idle";
+    return detail;
+}
 
-    // Get display seconds (current or preview during drag)
-    int displaySecs = history.displaySeconds;
-    if (m_zoomState.isDragging && m_zoomState.dragGpuUuid == stats.uuid) {
-        displaySecs = m_zoomState.previewDisplaySeconds;
+int GpuMonitorUI::displaySecondsFor(const std::string& uuid) const {
+    if (m_zoomState.isDragging && m_zoomState.dragGpuUuid == uuid) {
+        return m_zoomState.previewDisplaySeconds;
     }
+    auto it = m_metricHistory.find(uuid);
+    return it != m_metricHistory.end() ? it->second.displaySeconds : GpuMetricHistory::DEFAULT_DISPLAY_SECONDS;
+}
+
+void GpuMonitorUI::renderCompactMetrics(const GpuStats& stats) {
+    // Calculate fractions
+    float powerFrac = stats.powerLimit > 0 ? stats.powerDrawMw / (1000.0f * stats.powerLimit) : 0.0f;
+    float coreClockFrac = stats.device->gpuClockMax > 0 ? static_cast<float>(stats.gpuClock) / stats.device->gpuClockMax : 0.0f;
+    float memClockFrac = stats.device->memClockMax > 0 ? static_cast<float>(stats.memClock) / stats.device->memClockMax : 0.0f;
 
-    // Temporarily override for data retrieval
-    int savedDisplaySecs = history.displaySeconds;
-    history.displaySeconds = displaySecs;
+    // Get history (already updated by renderGpuCard)
+    const GpuMetricHistory& history = m_metricHistory[stats.device->uuid];
+    int displaySecs = displaySecondsFor(stats.device->uuid);
 
     // Get ordered history data for each metric
-    float powerData[GpuMetricHistory::HISTORY_SIZE];
-    float coreData[GpuMetricHistory::HISTORY_SIZE];
-    float memData[GpuMetricHistory::HISTORY_SIZE];
+    float powerData[GpuMetricHistory::PLOT_POINTS];
+    float coreData[GpuMetricHistory::PLOT_POINTS];
+    float memData[GpuMetricHistory::PLOT_POINTS];
+    unsigned int eventData[GpuMetricHistory::PLOT_POINTS];
     size_t dataCount = 0;
-    history.getOrderedMetric(history.powerHistory, powerData, dataCount);
-    history.getOrderedMetric(history.coreClockHistory, coreData, dataCount);
-    history.getOrderedMetric(history.memClockHistory, memData, dataCount);
+    long long nowUs = CaptureTime::now().steadyUs;
+    history.getOrderedMetric(history.powerHistory, powerData, dataCount, nowUs, displaySecs);
+    history.getOrderedMetric(history.coreClockHistory, coreData, dataCount, nowUs, displaySecs);
+    history.getOrderedMetric(history.memClockHistory, memData, dataCount, nowUs, displaySecs);
+    history.getOrderedMetric(history.clockEventHistory.get(), eventData, dataCount, nowUs, displaySecs);
+    double windowJoules = 0.0;
+    bool hasEnergy = history.windowEnergy(nowUs, displaySecs, windowJoules);
+
+    std::string powerSparkId = "##spark_power_" + stats.device->uuid;
+    std::string coreSparkId = "##spark_core_" + stats.device->uuid;
+    std::string memSparkId = "##spark_mem_" + stats.device->uuid;
+
+    // Pre-format value strings (stack buffers to avoid heap allocations)
+    char powerValueStr[32], coreValueStr[32], memValueStr[32];
+    snprintf(powerValueStr, sizeof(powerValueStr), "%u/%uW", stats.powerDraw, stats.powerLimit);
+    snprintf(coreValueStr, sizeof(coreValueStr), "%u/%uMHz", stats.gpuClock, stats.device->gpuClockMax);
+    snprintf(memValueStr, sizeof(memValueStr), "%u/%uMHz", stats.memClock, stats.device->memClockMax);
+    std::string coreDetail = throttleDetail(stats);
+
+    // Energy over the window from the hardware counter, exact regardless of the poll rate
+    char powerDetail[96], energyStr[48];
+    if (hasEnergy) {
+        formatEnergy(energyStr, sizeof(energyStr), windowJoules);
+        snprintf(powerDetail, sizeof(powerDetail), "%.1f W\nEnergy over %ds: %s",
+                 stats.powerDrawMw / 1000.0, displaySecs, energyStr);
+    } else {
+        snprintf(powerDetail, sizeof(powerDetail), "%.1f W\nNo energy counter on this GPU",
+                 stats.powerDrawMw / 1000.0);
+    }
 
-    history.displaySeconds = savedDisplaySecs;  // Restore
+    SparklineMetric metrics[] = {
+        {"Power", powerValueStr, powerFrac, powerData, powerSparkId.c_str(), powerDetail},
+        {"Core", coreValueStr, coreClockFrac, coreData, coreSparkId.c_str(), coreDetail.c_str(), eventData},
+        {"Mem", memValueStr, memClockFrac, memData, memSparkId.c_str()}
+    };
+    renderSparklineRow(stats, metrics, dataCount, displaySecs);
+}
+
+void GpuMonitorUI::renderSparklineRow(const GpuStats& stats, std::span<const SparklineMetric> metrics,
+                                      size_t dataCount, int displaySecs) {
+    GpuMetricHistory& history = m_metricHistory[stats.device->uuid];
 
     // Health colors
     ImVec4 healthColors[] = {
@@ -681,47 +779,28 @@ void GpuMonitorUI::renderCompactMetrics(const GpuStats& stats) {
     float circleRadius = 5.0f;
     float rightMargin = 12.0f;  // Same as full-width sparklines
     float columnSpacing = 15.0f;
-    // Total usable width = availableWidth - rightMargin, split into 3 columns with 2 gaps
+    // Total usable width = availableWidth - rightMargin, split into 3 columns with 2 gaps.
+    // Rows with fewer metrics leave the remaining columns empty so the grid lines up.
     float columnWidth = (availableWidth - rightMargin - 2 * columnSpacing) / 3.0f;
     float sparklineHeight = 35.0f;
     float headerHeight = ImGui::GetTextLineHeight() + 4.0f;
 
+    // Event strips sit in a band under the sparklines; the row only grows when one is shown
+    bool hasStrip = std::ranges::any_of(metrics, [](const SparklineMetric& m) { return m.events != nullptr; });
+    float stripHeight = hasStrip ? 6.0f : 0.0f;
+
     // Check for sparkline interaction (only if not in card drag mode)
     bool canInteract = !m_dragState.isDragging;
-    bool isThisGpuZooming = m_zoomState.isDragging && m_zoomState.dragGpuUuid == stats.uuid;
-
-    // Metric data for iteration
-    struct MetricInfo {
-        const char* label;
-        const char* valueStr;  // Pre-formatted value string
-        float frac;
-        const float* data;
-        const char* sparkId;
-    };
-
-    std::string powerSparkId = "##spark_power_" + stats.uuid;
-    std::string coreSparkId = "##spark_core_" + stats.uuid;
-    std::string memSparkId = "##spark_mem_" + stats.uuid;
-
-    // Pre-format value strings (stack buffers to avoid heap allocations)
-    char powerValueStr[32], coreValueStr[32], memValueStr[32];
-    snprintf(powerValueStr, sizeof(powerValueStr), "%u/%uW", stats.powerDraw, stats.powerLimit);
-    snprintf(coreValueStr, sizeof(coreValueStr), "%u/%uMHz", stats.gpuClock, stats.gpuClockMax);
-    snprintf(memValueStr, sizeof(memValueStr), "%u/%uMHz", stats.memClock, stats.memClockMax);
-
-    MetricInfo metrics[] = {
-        {"Power", powerValueStr, powerFrac, powerData, powerSparkId.c_str()},
-        {"Core", coreValueStr, coreClockFrac, coreData, coreSparkId.c_str()},
-        {"Mem", memValueStr, memClockFrac, memData, memSparkId.c_str()}
-    };
+    bool isThisGpuZooming = m_zoomState.isDragging && m_zoomState.dragGpuUuid == stats.device->uuid;
 
     bool anyHovered = false;
+    const char* hoveredDetail = nullptr;
     ImVec2 startPos = ImGui::GetCursorScreenPos();
     ImDrawList* drawList = ImGui::GetWindowDrawList();
 
     float leftOffset = circleRadius * 2 + 8;  // Circle + padding, same as full-width
 
-    for (int col = 0; col < 3; col++) {
+    for (size_t col = 0; col < std::min<size_t>(metrics.size(), 3); col++) {
         const auto& m = metrics[col];
         float colX = startPos.x + col * (columnWidth + columnSpacing);
         float sparklineWidth = columnWidth - leftOffset;  // Sparkline fills rest of column
@@ -768,6 +847,24 @@ void GpuMonitorUI::renderCompactMetrics(const GpuStats& stats) {
             }
         }
 
+        // Event strip: one block per run of points with the same color
+        if (m.events && dataCount > 1) {
+            float xStep = sparkSize.x / (dataCount - 1);
+            float stripY = sparkPos.y + sparkSize.y + 2;
+            size_t runStart = 0;
+            for (size_t i = 1; i <= dataCount; i++) {
+                ImU32 color = throttleColor(m.events[runStart]);
+                if (i < dataCount && throttleColor(m.events[i]) == color) continue;
+                if (color != 0) {
+                    float x1 = sparkPos.x + runStart * xStep;
+                    float x2 = sparkPos.x + std::min(i, dataCount - 1) * xStep;
+                    drawList->AddRectFilled(ImVec2(x1, stripY),
+                        ImVec2(std::max(x2, x1 + 1), stripY + stripHeight - 2), color);
+                }
+                runStart = i;
+            }
+        }
+
         // Sparkline border
         ImU32 borderColor = isThisGpuZooming ? IM_COL32(100, 150, 255, 255) : IM_COL32(50, 50, 55, 255);
         drawList->AddRect(sparkPos,
@@ -780,6 +877,7 @@ void GpuMonitorUI::renderCompactMetrics(const GpuStats& stats) {
         bool thisHovered = ImGui::IsItemHovered();
         if (thisHovered) {
             anyHovered = true;
+            hoveredDetail = m.detail;
 
             // Time label only shown on hover (vertically centered, right-aligned)
             char timeLabel[16];
@@ -794,14 +892,14 @@ void GpuMonitorUI::renderCompactMetrics(const GpuStats& stats) {
     }
 
     // Move cursor past our custom drawing
-    ImGui::SetCursorScreenPos(ImVec2(startPos.x, startPos.y + headerHeight + sparklineHeight + 8));
+    ImGui::SetCursorScreenPos(ImVec2(startPos.x, startPos.y + headerHeight + sparklineHeight + stripHeight + 8));
 
     // Handle zoom drag interaction (initiation only - ongoing drag is handled in renderGpuCard)
     if (canInteract) {
         // Start drag on any sparkline
         if (anyHovered && ImGui::IsMouseClicked(ImGuiMouseButton_Left)) {
             m_zoomState.isDragging = true;
-            m_zoomState.dragGpuUuid = stats.uuid;
+            m_zoomState.dragGpuUuid = stats.device->uuid;
             m_zoomState.dragStartX = ImGui::GetMousePos().x;
             m_zoomState.originalDisplaySeconds = history.displaySeconds;
             m_zoomState.previewDisplaySeconds = history.displaySeconds;
@@ -814,11 +912,207 @@ void GpuMonitorUI::renderCompactMetrics(const GpuStats& stats) {
 
         // Simple tooltip when hovering (not dragging)
         if (anyHovered && !m_zoomState.isDragging) {
-            ImGui::SetTooltip("Drag to time-dilate | Right-click to reset");
+            if (hoveredDetail) {
+                ImGui::SetTooltip("%s\n\nDrag to time-dilate | Right-click to reset", hoveredDetail);
+            } else {
+                ImGui::SetTooltip("Drag to time-dilate | Right-click to reset");
+            }
         }
     }
 }
 
+// Throughput for display, in the largest unit that keeps it above 1
+static void formatRate(char* text, size_t size, double bytesPerSec) {
+    if (bytesPerSec >= 1e9) {
+        snprintf(text, size, "%.1fGB/s", bytesPerSec / 1e9);
+    } else if (bytesPerSec >= 1e6) {
+        snprintf(text, size, "%.0fMB/s", bytesPerSec / 1e6);
+    } else {
+        snprintf(text, size, "%.0fKB/s", bytesPerSec / 1e3);
+    }
+}
+
+void GpuMonitorUI::renderInterconnectMetrics(const GpuStats& stats) {
+    const GpuMetricHistory& history = m_metricHistory[stats.device->uuid];
+    int displaySecs = displaySecondsFor(stats.device->uuid);
+
+    float txData[GpuMetricHistory::PLOT_POINTS];
+    float rxData[GpuMetricHistory::PLOT_POINTS];
+    float nvlinkData[GpuMetricHistory::PLOT_POINTS];
+    size_t dataCount = 0;
+    long long nowUs = CaptureTime::now().steadyUs;
+    history.getOrderedMetric(history.pcieTxHistory.get(), txData, dataCount, nowUs, displaySecs);
+    history.getOrderedMetric(history.pcieRxHistory.get(), rxData, dataCount, nowUs, displaySecs);
+    history.getOrderedMetric(history.nvlinkHistory.get(), nvlinkData, dataCount, nowUs, displaySecs);
+
+    // PCIe is measured against the link's current gen/width (which drops at idle on most
+    // boards). NVLink has no reliable per-version peak in NVML, so its sparkline is scaled
+    // to the busiest point in the window.
+    double pcieMax = pcieBandwidth(stats.pcieGen, stats.pcieWidth);
+    float txFrac = pcieMax > 0 ? static_cast<float>(stats.pcieRate.txBytesPerSec / pcieMax) : 0.0f;
+    float rxFrac = pcieMax > 0 ? static_cast<float>(stats.pcieRate.rxBytesPerSec / pcieMax) : 0.0f;
+    float nvlinkPeak = 0.0f;
+    for (size_t i = 0; i < dataCount; i++) nvlinkPeak = std::max(nvlinkPeak, nvlinkData[i]);
+    for (size_t i = 0; i < dataCount; i++) nvlinkData[i] = nvlinkPeak > 0 ? nvlinkData[i] / nvlinkPeak : 0.0f;
+    double nvlinkTotal = stats.nvlinkRate.txBytesPerSec + stats.nvlinkRate.rxBytesPerSec;
+    float nvlinkFrac = nvlinkPeak > 0 ? std::min(1.0f, static_cast<float>(nvlinkTotal) / nvlinkPeak) : 0.0f;
+
+    std::string txSparkId = "##spark_pcie_tx_" + stats.device->uuid;
+    std::string rxSparkId = "##spark_pcie_rx_" + stats.device->uuid;
+    std::string nvlinkSparkId = "##spark_nvlink_" + stats.device->uuid;
+
+    char txValueStr[32], rxValueStr[32], nvlinkValueStr[32];
+    formatRate(txValueStr, sizeof(txValueStr), stats.pcieRate.txBytesPerSec);
+    formatRate(rxValueStr, sizeof(rxValueStr), stats.pcieRate.rxBytesPerSec);
+    formatRate(nvlinkValueStr, sizeof(nvlinkValueStr), nvlinkTotal);
+
+    // Hover details: the link's peak and replays for PCIe, the per-link split for NVLink
+    char pcieDetail[160];
+    snprintf(pcieDetail, sizeof(pcieDetail), "Gen%u x%u: %.1f GB/s per direction\nReplays: %.1f/s",
+             stats.pcieGen, stats.pcieWidth, pcieMax / 1e9, stats.pcieReplayRate);
+    std::string nvlinkDetail = "TX / RX per link";
+    for (size_t link = 0; link < stats.nvlinkLinkRates.size(); link++) {
+        char tx[32], rx[32];
+        formatRate(tx, sizeof(tx), stats.nvlinkLinkRates[link].txBytesPerSec);
+        formatRate(rx, sizeof(rx), stats.nvlinkLinkRates[link].rxBytesPerSec);
+        nvlinkDetail += "\n  " + std::to_string(link) + ": " + tx + " / " + rx;
+    }
+
+    SparklineMetric metrics[] = {
+        {"PCIe TX", txValueStr, txFrac, txData, txSparkId.c_str(), pcieDetail},
+        {"PCIe RX", rxValueStr, rxFrac, rxData, rxSparkId.c_str(), pcieDetail},
+        {"NVLink", nvlinkValueStr, nvlinkFrac, nvlinkData, nvlinkSparkId.c_str(), nvlinkDetail.c_str()}
+    };
+    size_t columns = stats.nvlinkLinkRates.empty() ? 2 : 3;
+    renderSparklineRow(stats, std::span<const SparklineMetric>(metrics, columns), dataCount, displaySecs);
+}
+
+void GpuMonitorUI::renderProfilingMetrics(const GpuStats& stats) {
+    const GpuMetricHistory& history = m_metricHistory[stats.device->uuid];
+    int displaySecs = displaySecondsFor(stats.device->uuid);
+
+    float smData[GpuMetricHistory::PLOT_POINTS];
+    float tensorData[GpuMetricHistory::PLOT_POINTS];
+    float dramData[GpuMetricHistory::PLOT_POINTS];
+    size_t dataCount = 0;
+    long long nowUs = CaptureTime::now().steadyUs;
+    history.getOrderedMetric(history.smActivityHistory.get(), smData, dataCount, nowUs, displaySecs);
+    history.getOrderedMetric(history.tensorHistory.get(), tensorData, dataCount, nowUs, displaySecs);
+    history.getOrderedMetric(history.dramHistory.get(), dramData, dataCount, nowUs, displaySecs);
+
+    const GpmMetrics& gpm = stats.gpm;
+    std::string smSparkId = "##spark_sm_" + stats.device->uuid;
+    std::string tensorSparkId = "##spark_tensor_" + stats.device->uuid;
+    std::string dramSparkId = "##spark_dram_" + stats.device->uuid;
+
+    char smValueStr[32], tensorValueStr[32], dramValueStr[32];
+    snprintf(smValueStr, sizeof(smValueStr), "%.0f%%", gpm.smActivity);
+    snprintf(tensorValueStr, sizeof(tensorValueStr), "%.0f%%", gpm.tensorActivity);
+    snprintf(dramValueStr, sizeof(dramValueStr), "%.0f%%", gpm.dramBandwidth);
+
+    // Utilization only says a kernel was running; these say how much of the GPU it used.
+    // The DRAM tooltip adds the interconnect rates GPM measures over the same interval.
+    char smDetail[160], dramDetail[192], tx[32], rx[32], nvTx[32], nvRx[32];
+    snprintf(smDetail, sizeof(smDetail), "Time SMs had work: %.1f%% (utilization %u%%)\nOccupancy: %.1f%% of max warps",
+             gpm.smActivity, stats.gpuUtilization, gpm.smOccupancy);
+    formatRate(tx, sizeof(tx), gpm.pcieTxBytesPerSec);
+    formatRate(rx, sizeof(rx), gpm.pcieRxBytesPerSec);
+    formatRate(nvTx, sizeof(nvTx), gpm.nvlinkTxBytesPerSec);
+    formatRate(nvRx, sizeof(nvRx), gpm.nvlinkRxBytesPerSec);
+    snprintf(dramDetail, sizeof(dramDetail), "DRAM bandwidth: %.1f%% of peak\nPCIe TX / RX: %s / %s\nNVLink TX / RX: %s / %s",
+             gpm.dramBandwidth, tx, rx, nvTx, nvRx);
+
+    SparklineMetric metrics[] = {
+        {"SM", smValueStr, static_cast<float>(gpm.smActivity / 100.0), smData, smSparkId.c_str(), smDetail},
+        {"Tensor", tensorValueStr, static_cast<float>(gpm.tensorActivity / 100.0), tensorData, tensorSparkId.c_str(),
+         "Time any tensor pipe was busy"},
+        {"DRAM", dramValueStr, static_cast<float>(gpm.dramBandwidth / 100.0), dramData, dramSparkId.c_str(), dramDetail}
+    };
+    renderSparklineRow(stats, metrics, dataCount, displaySecs);
+}
+
+// Short label for a topology cell, as in `nvidia-smi topo -m` (NV# = bonded NVLinks,
+// NVS = NVLink through an NVSwitch, otherwise where the PCIe paths meet)
+static std::string topologyLabel(const GpuPeerLink& link) {
+    if (link.nvlinkCount > 0) return "NV" + std::to_string(link.nvlinkCount);
+    if (link.p2pNvlink) return "NVS";
+    switch (link.level) {
+        case TOPO_SAME_BOARD:    return "BRD";
+        case TOPO_PCIE_SWITCH:   return "PIX";
+        case TOPO_PCIE_SWITCHES: return "PXB";
+        case TOPO_HOST_BRIDGE:   return "PHB";
+        case TOPO_NUMA_NODE:     return "NODE";
+        case TOPO_SYSTEM:        return "SYS";
+        default:                 return "?";
+    }
+}
+
+static const char* topologyDescription(TopologyLevel level) {
+    switch (level) {
+        case TOPO_SAME_BOARD:    return "Same board";
+        case TOPO_PCIE_SWITCH:   return "Same PCIe switch";
+        case TOPO_PCIE_SWITCHES: return "Across PCIe switches";
+        case TOPO_HOST_BRIDGE:   return "Same PCIe host bridge";
+        case TOPO_NUMA_NODE:     return "Same NUMA node, different host bridges";
+        case TOPO_SYSTEM:        return "Across NUMA nodes";
+        default:                 return "Unknown PCIe path";
+    }
+}
+
+void GpuMonitorUI::renderTopology(const GpuTopology& topology) {
+    size_t count = topology.cudaIndices.size();
+    if (!ImGui::BeginTable("##topology", static_cast<int>(count) + 1,
+            ImGuiTableFlags_BordersInner | ImGuiTableFlags_SizingFixedFit | ImGuiTableFlags_NoHostExtendX)) {
+        return;
+    }
+
+    ImGui::TableNextRow(ImGuiTableRowFlags_Headers);
+    ImGui::TableNextColumn();
+    for (unsigned int index : topology.cudaIndices) {
+        ImGui::TableNextColumn();
+        ImGui::TextDisabled("GPU%u", index);
+    }
+
+    for (size_t row = 0; row < count; row++) {
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        ImGui::TextDisabled("GPU%u", topology.cudaIndices[row]);
+        for (size_t column = 0; column < count; column++) {
+            ImGui::TableNextColumn();
+            if (row == column) {
+                ImGui::TextDisabled("X");
+                continue;
+            }
+
+            // NVLink in green, P2P over PCIe in the normal text color, no P2P dimmed
+            const GpuPeerLink& link = topology.link(row, column);
+            std::string label = topologyLabel(link);
+            if (link.nvlinkCount > 0 || link.p2pNvlink) {
+                ImGui::TextColored(ImVec4(0.3f, 0.85f, 0.3f, 1.0f), "%s", label.c_str());
+            } else if (link.p2pRead || link.p2pWrite) {
+                ImGui::TextUnformatted(label.c_str());
+            } else {
+                ImGui::TextDisabled("%s", label.c_str());
+            }
+
+            if (ImGui::IsItemHovered()) {
+                ImGui::BeginTooltip();
+                ImGui::Text("GPU%u -> GPU%u", topology.cudaIndices[row], topology.cudaIndices[column]);
+                ImGui::TextDisabled("%s", topologyDescription(link.level));
+                if (link.nvlinkCount > 0) {
+                    ImGui::Text("NVLink: %u links (version %u)", link.nvlinkCount, link.nvlinkVersion);
+                } else if (link.p2pNvlink) {
+                    ImGui::Text("NVLink: through NVSwitch");
+                }
+                ImGui::Text("P2P read: %s, write: %s, atomics: %s", link.p2pRead ? "yes" : "no",
+                            link.p2pWrite ? "yes" : "no", link.p2pAtomics ? "yes" : "no");
+                ImGui::EndTooltip();
+            }
+        }
+    }
+    ImGui::EndTable();
+}
+
 void GpuMonitorUI::renderSystemHealth(const SystemInfo& sysInfo) {
     // Disable interaction during modal states
     if (isModalActive()) {
@@ -829,6 +1123,36 @@ void GpuMonitorUI::renderSystemHealth(const SystemInfo& sysInfo) {
     ImGui::TextDisabled("Driver %s", sysInfo.driverVersion.c_str());
     ImGui::SameLine();
     ImGui::TextDisabled("| CUDA %s", sysInfo.cudaVersion.c_str());
+    if (ImGui::IsItemHovered()) {
+        const PollStats& poll = sysInfo.poll;
+        ImGui::BeginTooltip();
+        ImGui::Text("NVML calls avoided by caching: %llu", sysInfo.nvmlCallsAvoided);
+        ImGui::Text("Poll tick: %u ms, last poll %.1f ms (max %.1f ms)", poll.intervalMs,
+                    poll.pollLastUs / 1000.0f, poll.pollMaxUs / 1000.0f);
+        ImGui::Text("Wake jitter: %.2f ms avg, %.2f ms max", poll.jitterMeanUs / 1000.0f, poll.jitterMaxUs / 1000.0f);
+        if (poll.overruns > 0) {
+            ImGui::TextColored(ImVec4(1.0f, 0.7f, 0.3f, 1.0f), "Overruns: %llu of %llu ticks (%llu skipped)",
+                               poll.overruns, poll.ticks, poll.missedTicks);
+        }
+        ImGui::EndTooltip();
+    }
+
+    // Driver call latency (only when the backend times its calls)
+    if (sysInfo.callLatency) {
+        ImGui::SameLine();
+        if (ImGui::SmallButton(ICON_FA_STETHOSCOPE "##diagnostics")) {
+            m_showDiagnostics = !m_showDiagnostics;
+        }
+        if (ImGui::IsItemHovered()) {
+            ImGui::SetTooltip("NVML call latency");
+        }
+    }
+
+    // Data source badge (only shown when not reading real hardware)
+    if (!sysInfo.backendName.empty() && sysInfo.backendName != "NVML") {
+        ImGui::SameLine();
+        ImGui::TextColored(ImVec4(0.95f, 0.75f, 0.3f, 1.0f), "| %s", sysInfo.backendName.c_str());
+    }
 
     // NVLink status (only show if connected)
     if (sysInfo.nvlinkAvailable) {
@@ -840,6 +1164,14 @@ void GpuMonitorUI::renderSystemHealth(const SystemInfo& sysInfo) {
         }
     }
 
+    // Pairwise interconnect, collapsed by default (only useful with two or more GPUs)
+    if (sysInfo.topology && sysInfo.topology->cudaIndices.size() >= 2) {
+        if (ImGui::TreeNode(ICON_FA_NETWORK_WIRED " Topology")) {
+            renderTopology(*sysInfo.topology);
+            ImGui::TreePop();
+        }
+    }
+
     ImGui::Spacing();
 
     if (isModalActive()) {
@@ -847,6 +1179,26 @@ void GpuMonitorUI::renderSystemHealth(const SystemInfo& sysInfo) {
     }
 }
 
+// Short MIG profile ("3g.40gb") from the instance's name
+static std::string migProfileName(const MigInstance& instance) {
+    size_t pos = instance.name.rfind(" MIG ");
+    return pos != std::string::npos ? instance.name.substr(pos + 5) : instance.name;
+}
+
+// Position of `uuid` as a whole entry of a comma-separated UUID list, or npos. Entries
+// are compared whole because an old-style MIG UUID (MIG-GPU-<uuid>/<gi>/<ci>) contains
+// its parent GPU's UUID.
+static size_t findUuidEntry(const std::string& uuids, const std::string& uuid) {
+    if (uuid.empty()) return std::string::npos;
+    for (size_t pos = uuids.find(uuid); pos != std::string::npos; pos = uuids.find(uuid, pos + 1)) {
+        size_t end = pos + uuid.length();
+        if ((pos == 0 || uuids[pos - 1] == ',') && (end == uuids.length() || uuids[end] == ',')) {
+            return pos;
+        }
+    }
+    return std::string::npos;
+}
+
 std::string GpuMonitorUI::buildGpuSelectionString(const QuickLaunchPreset& preset, const std::vector<GpuStats>& gpuStats) {
     // Build CUDA_VISIBLE_DEVICES string from selected GPU UUIDs
     // If no GPUs selected (empty string), return empty (means all)
@@ -854,27 +1206,37 @@ std::string GpuMonitorUI::buildGpuSelectionString(const QuickLaunchPreset& prese
         return "";
     }
 
+    // MIG instances can only be named by UUID; once one is selected, whole GPUs are
+    // named by UUID too rather than mixing the two forms
+    const std::string& selected = preset.selectedGpuUuids;
+    bool byUuid = selected.starts_with("MIG-") || selected.find(",MIG-") != std::string::npos;
+
     std::string result;
 
     for (const auto& gpu : gpuStats) {
         // Check if this GPU's UUID is in the selected list
-        if (preset.selectedGpuUuids.find(gpu.uuid) != std::string::npos) {
+        if (findUuidEntry(selected, gpu.device->uuid) != std::string::npos) {
             if (!result.empty()) result += ",";
-            result += std::to_string(gpu.cudaIndex);
+            result += byUuid ? gpu.device->uuid : std::to_string(gpu.device->cudaIndex);
+        }
+        for (const auto& instance : gpu.migInstances) {
+            if (findUuidEntry(selected, instance.uuid) != std::string::npos) {
+                if (!result.empty()) result += ",";
+                result += instance.uuid;
+            }
         }
     }
     return result;
 }
 
 bool GpuMonitorUI::isGpuSelectedInPreset(const QuickLaunchPreset& preset, const std::string& uuid) {
-    if (preset.selectedGpuUuids.empty()) return false;
-    return preset.selectedGpuUuids.find(uuid) != std::string::npos;
+    return findUuidEntry(preset.selectedGpuUuids, uuid) != std::string::npos;
 }
 
 void GpuMonitorUI::toggleGpuInPreset(QuickLaunchPreset& preset, const std::string& uuid) {
     std::string& uuids = preset.selectedGpuUuids;
 
-    size_t pos = uuids.find(uuid);
+    size_t pos = findUuidEntry(uuids, uuid);
     if (pos != std::string::npos) {
         // Remove this UUID
         size_t end = pos + uuid.length();
@@ -920,7 +1282,7 @@ void GpuMonitorUI::renderQuickLaunch(const std::vector<GpuStats>& gpuStats) {
             } else {
                 int count = 0;
                 for (const auto& gpu : gpuStats) {
-                    if (isGpuSelectedInPreset(preset, gpu.uuid)) {
+                    if (isGpuSelectedInPreset(preset, gpu.device->uuid)) {
                         if (count > 0) gpuLabel += ", ";
                         gpuLabel += getGpuDisplayName(gpu);
                         count++;
@@ -1051,12 +1413,26 @@ void GpuMonitorUI::renderQuickLaunch(const std::vector<GpuStats>& gpuStats) {
 
                 // Dynamic GPU checkboxes
                 for (const auto& gpu : gpuStats) {
-                    ImGui::PushID(gpu.uuid.c_str());
-                    bool selected = isGpuSelectedInPreset(preset, gpu.uuid);
-                    std::string label = getGpuDisplayName(gpu) + " (cuda:" + std::to_string(gpu.cudaIndex) + ")";
+                    ImGui::PushID(gpu.device->uuid.c_str());
+                    bool selected = isGpuSelectedInPreset(preset, gpu.device->uuid);
+                    std::string label = getGpuDisplayName(gpu) + " (cuda:" + std::to_string(gpu.device->cudaIndex) + ")";
                     if (ImGui::Checkbox(label.c_str(), &selected)) {
-                        toggleGpuInPreset(preset, gpu.uuid);
+                        toggleGpuInPreset(preset, gpu.device->uuid);
+                    }
+
+                    // MIG instances of the GPU, selectable on their own
+                    ImGui::Indent(20);
+                    for (const auto& instance : gpu.migInstances) {
+                        ImGui::PushID(instance.uuid.c_str());
+                        bool instanceSelected = isGpuSelectedInPreset(preset, instance.uuid);
+                        std::string instanceLabel = "MIG " + migProfileName(instance) +
+                            " (GI " + std::to_string(instance.gpuInstanceId) + ")";
+                        if (ImGui::Checkbox(instanceLabel.c_str(), &instanceSelected)) {
+                            toggleGpuInPreset(preset, instance.uuid);
+                        }
+                        ImGui::PopID();
                     }
+                    ImGui::Unindent(20);
                     ImGui::PopID();
                 }
 
@@ -1162,17 +1538,36 @@ void GpuMonitorUI::renderQuickLaunch(const std::vector<GpuStats>& gpuStats) {
 void GpuMonitorUI::renderProcessesSection(const GpuStats& stats) {
     if (stats.processes.empty()) {
         ImGui::TextDisabled("No processes running");
-        return;
     }
 
     for (const auto& proc : stats.processes) {
         ImGui::PushID(proc.pid);
 
-        // Process name and PID
+        // Process name and PID (hover for the full command line)
         ImGui::Text("%s", proc.name.c_str());
+        if (ImGui::IsItemHovered() && (!proc.commandLine.empty() || !proc.user.empty())) {
+            ImGui::BeginTooltip();
+            if (!proc.commandLine.empty()) {
+                ImGui::PushTextWrapPos(ImGui::GetFontSize() * 40.0f);
+                ImGui::TextUnformatted(proc.commandLine.c_str());
+                ImGui::PopTextWrapPos();
+            }
+            if (!proc.user.empty()) {
+                ImGui::TextDisabled("User: %s", proc.user.c_str());
+            }
+            ImGui::EndTooltip();
+        }
         ImGui::SameLine();
         ImGui::TextDisabled("(PID: %u)", proc.pid);
 
+        // Share of the GPU this process is using (encoder/decoder only when active)
+        ImGui::SameLine();
+        ImGui::TextDisabled("SM %u%% | Mem %u%%", proc.smUtil, proc.memUtil);
+        if (proc.encUtil > 0 || proc.decUtil > 0) {
+            ImGui::SameLine();
+            ImGui::TextDisabled("| Enc %u%% | Dec %u%%", proc.encUtil, proc.decUtil);
+        }
+
         // Kill button on the right
         ImGui::SameLine(ImGui::GetContentRegionAvail().x - 30);
         if (ImGui::SmallButton(ICON_FA_SKULL)) {
@@ -1195,13 +1590,99 @@ void GpuMonitorUI::renderProcessesSection(const GpuStats& stats) {
         ImGui::PopID();
     }
 
+    // Recently exited (accounting mode only), newest first
+    if (!stats.exitedProcesses.empty()) {
+        long long nowUs = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+
+        ImGui::Spacing();
+        ImGui::TextDisabled("Recently exited");
+        for (auto it = stats.exitedProcesses.rbegin(); it != stats.exitedProcesses.rend(); ++it) {
+            long long endUs = it->startTimeUs + static_cast<long long>(it->durationMs) * 1000;
+            double agoSec = std::max(0.0, static_cast<double>(nowUs - endUs) / 1e6);
+            float peakGB = static_cast<float>(it->maxMemory) / (1024.0f * 1024.0f * 1024.0f);
+
+            ImGui::Text("%s", it->name.c_str());
+            ImGui::SameLine();
+            ImGui::TextDisabled("(PID: %u) ran %.1fs | peak %.1fGB | SM %u%% | Mem %u%% | %.0fs ago",
+                                it->pid, static_cast<double>(it->durationMs) / 1000.0, peakGB,
+                                it->gpuUtil, it->memUtil, agoSec);
+        }
+    }
+
     // ECC errors (hidden by default, show if supported)
-    if (stats.eccSupported && stats.eccErrors > 0) {
+    if (stats.device->eccSupported && stats.eccErrors > 0) {
         ImGui::Spacing();
         ImGui::TextColored(ImVec4(1.0f, 0.7f, 0.3f, 1.0f), "ECC Errors: %llu", stats.eccErrors);
     }
 }
 
+void GpuMonitorUI::renderMigInstances(const GpuStats& stats) {
+    ImGui::TextColored(ImVec4(0.6f, 0.8f, 1.0f, 1.0f), ICON_FA_TABLE_CELLS " MIG Instances (%zu)",
+                       stats.migInstances.size());
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+
+    for (const auto& instance : stats.migInstances) {
+        ImGui::PushID(instance.uuid.c_str());
+        ImGui::Indent(10);
+        ImGui::BeginGroup();
+
+        // Profile and IDs (hover for the UUID), copy-UUID button on the right
+        ImGui::Text("%s", migProfileName(instance).c_str());
+        if (ImGui::IsItemHovered()) {
+            ImGui::SetTooltip("%s\n%s", instance.name.c_str(), instance.uuid.c_str());
+        }
+        ImGui::SameLine();
+        ImGui::TextDisabled("GI %u | CI %u | %u SMs", instance.gpuInstanceId, instance.computeInstanceId,
+                            instance.smCount);
+        ImGui::SameLine(ImGui::GetContentRegionAvail().x - 30);
+        if (ImGui::SmallButton(ICON_FA_COPY)) {
+            copyToClipboard(instance.uuid);
+            showCopiedToast("MIG UUID");
+        }
+
+        // Instance memory
+        float memFrac = instance.vramTotal > 0 ? static_cast<float>(instance.vramUsed) / instance.vramTotal : 0.0f;
+        char memStr[48];
+        snprintf(memStr, sizeof(memStr), "%.1f / %.1f GB",
+                 static_cast<double>(instance.vramUsed) / (1024.0 * 1024.0 * 1024.0),
+                 static_cast<double>(instance.vramTotal) / (1024.0 * 1024.0 * 1024.0));
+        ImGui::PushStyleColor(ImGuiCol_PlotHistogram, getHealthColor4(getVramHealth(memFrac)));
+        ImGui::ProgressBar(memFrac, ImVec2(-8, 0), memStr);
+        ImGui::PopStyleColor();
+
+        // Profiling metrics of the instance's GPU instance
+        if (instance.gpm.valid) {
+            ImGui::Text("SM %.0f%% | Occupancy %.0f%% | Tensor %.0f%% | DRAM %.0f%%", instance.gpm.smActivity,
+                        instance.gpm.smOccupancy, instance.gpm.tensorActivity, instance.gpm.dramBandwidth);
+        }
+
+        // Processes, named from the parent GPU's list
+        if (instance.processes.empty()) {
+            ImGui::TextDisabled("No processes");
+        }
+        for (const auto& proc : instance.processes) {
+            auto it = std::ranges::find(stats.processes, proc.pid, &GpuProcess::pid);
+            const char* name = it != stats.processes.end() ? it->name.c_str() : "Unknown";
+            ImGui::TextDisabled("%s (PID: %u) %.1fGB", name, proc.pid,
+                                static_cast<double>(proc.usedMemory) / (1024.0 * 1024.0 * 1024.0));
+        }
+
+        ImGui::EndGroup();
+
+        // Sub-card frame
+        ImVec2 frameMin = ImGui::GetItemRectMin();
+        ImVec2 frameMax = ImGui::GetItemRectMax();
+        drawList->AddRect(ImVec2(frameMin.x - 5, frameMin.y - 3), ImVec2(frameMax.x + 3, frameMax.y + 3),
+                          IM_COL32(60, 60, 70, 255), 4.0f);
+
+        ImGui::Unindent(10);
+        ImGui::Spacing();
+        ImGui::Spacing();
+        ImGui::PopID();
+    }
+}
+
 void GpuMonitorUI::render(const std::vector<GpuStats>& gpuStats, const SystemInfo& sysInfo) {
     ImGuiIO& io = ImGui::GetIO();
 
@@ -1270,7 +1751,7 @@ void GpuMonitorUI::render(const std::vector<GpuStats>& gpuStats, const SystemInf
         m_dragState.cardEndY.resize(sortedStats.size());
 
         for (size_t i = 0; i < sortedStats.size(); i++) {
-            renderGpuCard(sortedStats[i], gpuStats, static_cast<int>(i));
+            renderGpuCard(*sortedStats[i], gpuStats, static_cast<int>(i));
         }
 
         // Render drop indicator during drag
@@ -1298,6 +1779,9 @@ void GpuMonitorUI::render(const std::vector<GpuStats>& gpuStats, const SystemInf
     // Recording report modal
     renderRecordReport();
 
+    // Driver call latency window
+    renderDiagnostics(gpuStats, sysInfo);
+
     // Modal overlay (drawn on foreground, so after all other content)
     renderModalOverlay();
 
@@ -1365,42 +1849,66 @@ void GpuMonitorUI::renderRecordButton(const std::vector<GpuStats>& gpuStats) {
         if (ImGui::SmallButton(ICON_FA_CIRCLE " Rec")) {
             m_recording.reset();
             m_recording.isRecording = true;
+            m_recording.startUs = CaptureTime::now().steadyUs;
             m_recordPulseTimer = 0.0f;
             // Initialize per-GPU data
             for (const auto& stats : gpuStats) {
-                auto& data = m_recording.gpuData[stats.uuid];
-                data.gpuName = stats.name;
+                auto& data = m_recording.gpuData[stats.device->uuid];
+                data.gpuName = stats.device->name;
                 data.displayName = getGpuDisplayName(stats);
                 data.vramTotalGB = static_cast<float>(stats.vramTotal) / (1024.0f * 1024.0f * 1024.0f);
                 data.powerLimit = stats.powerLimit;
-                data.gpuClockMax = stats.gpuClockMax;
-                data.memClockMax = stats.memClockMax;
-                data.cudaIndex = stats.cudaIndex;
+                data.gpuClockMax = stats.device->gpuClockMax;
+                data.memClockMax = stats.device->memClockMax;
+                data.cudaIndex = stats.device->cudaIndex;
             }
         }
         ImGui::PopStyleColor(3);
     } else {
-        // Recording active — accumulate data
-        float deltaTime = io.DeltaTime;
-        m_recording.elapsedTime += deltaTime;
-        m_recordPulseTimer += deltaTime;
+        // Recording active — accumulate data, about one sample per second of capture time
+        m_recording.elapsedTime = static_cast<float>(CaptureTime::now().steadyUs - m_recording.startUs) / 1e6f;
+        m_recordPulseTimer += io.DeltaTime;
 
         for (const auto& stats : gpuStats) {
-            auto it = m_recording.gpuData.find(stats.uuid);
+            auto it = m_recording.gpuData.find(stats.device->uuid);
             if (it == m_recording.gpuData.end()) continue;
             auto& data = it->second;
-            data.timeSinceLastSample += deltaTime;
-            if (data.timeSinceLastSample >= 0.95f) {
+            if (data.lastSampleUs == 0 || stats.captured.steadyUs - data.lastSampleUs >= 950000) {
                 float vramGB = static_cast<float>(stats.vramUsed) / (1024.0f * 1024.0f * 1024.0f);
                 data.vramUsedGB.addSample(vramGB);
                 data.gpuUtilization.addSample(stats.gpuUtilization);
                 data.memUtilization.addSample(stats.memUtilization);
                 data.temperature.addSample(stats.temperature);
                 data.fanSpeed.addSample(stats.fanSpeed);
-                data.powerDraw.addSample(stats.powerDraw);
+                data.powerDraw.addSample(stats.powerDrawMw / 1000.0);
                 data.gpuClock.addSample(stats.gpuClock);
                 data.memClock.addSample(stats.memClock);
-                data.timeSinceLastSample = 0.0f;
+
+                // Throttle time: counter deltas where the driver keeps them, otherwise the
+                // current reasons held over the interval since the previous sample
+                double intervalSec = data.lastSampleUs != 0 ? (stats.captured.steadyUs - data.lastSampleUs) / 1e6 : 0.0;
+                for (size_t cause = 0; cause < THROTTLE_CAUSE_COUNT; cause++) {
+                    unsigned long long ns = stats.throttleTimeNs[cause];
+                    unsigned long long& last = data.throttleLastNs[cause];
+                    if (ns != 0) {
+                        if (last != 0 && ns >= last) data.throttleSeconds[cause] += (ns - last) / 1e9;
+                        last = ns;
+                    } else if (stats.clockEventReasons & throttleCauseReasons(static_cast<ThrottleCause>(cause))) {
+                        data.throttleSeconds[cause] += intervalSec;
+                    }
+                }
+
+                // Energy: exact from the counter, else power held over the interval
+                if (stats.energyMj != 0) {
+                    if (data.energyLastMj != 0 && stats.energyMj >= data.energyLastMj) {
+                        data.energyJ += (stats.energyMj - data.energyLastMj) / 1000.0;
+                    }
+                    data.energyLastMj = stats.energyMj;
+                } else {
+                    data.energyJ += stats.powerDrawMw / 1000.0 * intervalSec;
+                    data.energyEstimated = true;
+                }
+                data.lastSampleUs = stats.captured.steadyUs;
                 m_recording.totalSamples++;
             }
         }
@@ -1535,7 +2043,8 @@ void GpuMonitorUI::renderRecordReport() {
 
         auto renderMetricTable = [&](const char* tableId,
                 const GpuRecordedData& data, float refVramTotal,
-                unsigned int refPowerLimit, unsigned int refGpuClockMax, unsigned int refMemClockMax) {
+                unsigned int refPowerLimit, unsigned int refGpuClockMax, unsigned int refMemClockMax,
+                double gpuSeconds) {
 
             auto colorFor = [&](const char* metric, double val) -> ImVec4 {
                 if (strcmp(metric, "vram") == 0) {
@@ -1593,6 +2102,35 @@ void GpuMonitorUI::renderRecordReport() {
 
                 ImGui::EndTable();
             }
+
+            // Time the core clock was held back, per cause and as a share of the recording
+            std::string throttleId = std::string(tableId) + "_throttle";
+            if (ImGui::BeginTable(throttleId.c_str(), 3,
+                    ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp)) {
+
+                ImGui::TableSetupColumn("Clock Limited By", ImGuiTableColumnFlags_None, 3.0f);
+                ImGui::TableSetupColumn("Seconds", ImGuiTableColumnFlags_None, 1.5f);
+                ImGui::TableSetupColumn("Share", ImGuiTableColumnFlags_None, 1.5f);
+                ImGui::TableHeadersRow();
+
+                for (const auto& style : THROTTLE_CAUSE_STYLES) {
+                    double sec = data.throttleSeconds[style.cause];
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::TextColored(ImGui::ColorConvertU32ToFloat4(style.color), "%s", style.name);
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.1f", sec);
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.0f%%", gpuSeconds > 0 ? 100.0 * sec / gpuSeconds : 0.0);
+                }
+
+                ImGui::EndTable();
+            }
+
+            char energyStr[48];
+            formatEnergy(energyStr, sizeof(energyStr), data.energyJ);
+            ImGui::Text(ICON_FA_BOLT " Energy: %s%s", energyStr,
+                data.energyEstimated ? " (estimated from power samples)" : "");
         };
 
         // === Overall Summary (aggregate across all GPUs) ===
@@ -1622,13 +2160,19 @@ void GpuMonitorUI::renderRecordReport() {
                 mergeStats(overall.powerDraw, data.powerDraw);
                 mergeStats(overall.gpuClock, data.gpuClock);
                 mergeStats(overall.memClock, data.memClock);
+                for (size_t cause = 0; cause < THROTTLE_CAUSE_COUNT; cause++) {
+                    overall.throttleSeconds[cause] += data.throttleSeconds[cause];
+                }
+                overall.energyJ += data.energyJ;
+                overall.energyEstimated |= data.energyEstimated;
                 if (data.vramTotalGB > maxVramTotal) maxVramTotal = data.vramTotalGB;
                 if (data.powerLimit > maxPowerLim) maxPowerLim = data.powerLimit;
                 if (data.gpuClockMax > maxGpuClk) maxGpuClk = data.gpuClockMax;
                 if (data.memClockMax > maxMemClk) maxMemClk = data.memClockMax;
             }
 
-            renderMetricTable("##rec_overall", overall, maxVramTotal, maxPowerLim, maxGpuClk, maxMemClk);
+            renderMetricTable("##rec_overall", overall, maxVramTotal, maxPowerLim, maxGpuClk, maxMemClk,
+                m_recording.elapsedTime * gpuCount);
             ImGui::Spacing();
             ImGui::Separator();
             ImGui::Spacing();
@@ -1654,7 +2198,8 @@ void GpuMonitorUI::renderRecordReport() {
             if (ImGui::CollapsingHeader(header)) {
                 std::string tableId = "##rec_" + uuid;
                 renderMetricTable(tableId.c_str(), data,
-                    data.vramTotalGB, data.powerLimit, data.gpuClockMax, data.memClockMax);
+                    data.vramTotalGB, data.powerLimit, data.gpuClockMax, data.memClockMax,
+                    m_recording.elapsedTime);
                 ImGui::Spacing();
             }
         }
@@ -1677,6 +2222,117 @@ void GpuMonitorUI::renderRecordReport() {
     }
 }
 
+// Latency for display: microseconds below 1 ms, milliseconds above
+static std::string formatLatency(unsigned long long us) {
+    char text[32];
+    if (us < 1000) {
+        snprintf(text, sizeof(text), "%llu us", us);
+    } else {
+        snprintf(text, sizeof(text), "%.1f ms", us / 1000.0);
+    }
+    return text;
+}
+
+// Device label for a call latency row: the GPU's cuda index, or "System"
+static std::string latencyDeviceLabel(const CallLatency& entry, const std::vector<GpuStats>& gpuStats) {
+    if (entry.deviceUuid.empty()) return "System";
+    for (const auto& stats : gpuStats) {
+        if (stats.device->uuid == entry.deviceUuid) return "cuda:" + std::to_string(stats.device->cudaIndex);
+    }
+    return "(removed)";
+}
+
+// Slowest first, so a degrading device rises to the top
+static std::vector<const CallLatency*> sortBySlowest(const std::vector<CallLatency>& entries) {
+    std::vector<const CallLatency*> sorted;
+    for (const auto& entry : entries) sorted.push_back(&entry);
+    std::ranges::sort(sorted, [](const CallLatency* a, const CallLatency* b) {
+        return a->p99Us != b->p99Us ? a->p99Us > b->p99Us : a->maxUs > b->maxUs;
+    });
+    return sorted;
+}
+
+void GpuMonitorUI::renderDiagnostics(const std::vector<GpuStats>& gpuStats, const SystemInfo& sysInfo) {
+    if (!m_showDiagnostics || !sysInfo.callLatency) return;
+
+    ImGui::SetNextWindowSize(ImVec2(640, 420), ImGuiCond_Once);
+    if (!ImGui::Begin(ICON_FA_STETHOSCOPE " NVML Diagnostics", &m_showDiagnostics, ImGuiWindowFlags_NoCollapse)) {
+        ImGui::End();
+        return;
+    }
+
+    const auto& entries = *sysInfo.callLatency;
+    ImGui::TextDisabled("Latency of every NVML call since startup, slowest first. Slow calls are often "
+                        "the first sign of a degrading GPU.");
+    if (ImGui::SmallButton(ICON_FA_COPY " Copy")) {
+        copyToClipboard(formatDiagnosticsText(gpuStats, sysInfo));
+        showCopiedToast("Diagnostics");
+    }
+    ImGui::Spacing();
+
+    // p99 above 10 ms is unusual for NVML; above 100 ms the device is likely in trouble
+    auto latencyColor = [](unsigned long long us) {
+        if (us >= 100000) return ImVec4(1.0f, 0.35f, 0.35f, 1.0f);
+        if (us >= 10000) return ImVec4(1.0f, 0.7f, 0.3f, 1.0f);
+        return ImGui::GetStyle().Colors[ImGuiCol_Text];
+    };
+
+    if (ImGui::BeginTable("##call_latency", 7,
+            ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp)) {
+        ImGui::TableSetupColumn("Device", ImGuiTableColumnFlags_None, 1.0f);
+        ImGui::TableSetupColumn("Call", ImGuiTableColumnFlags_None, 3.5f);
+        ImGui::TableSetupColumn("Calls", ImGuiTableColumnFlags_None, 1.0f);
+        ImGui::TableSetupColumn("Errors", ImGuiTableColumnFlags_None, 0.8f);
+        ImGui::TableSetupColumn("p50", ImGuiTableColumnFlags_None, 1.0f);
+        ImGui::TableSetupColumn("p99", ImGuiTableColumnFlags_None, 1.0f);
+        ImGui::TableSetupColumn("Max", ImGuiTableColumnFlags_None, 1.0f);
+        ImGui::TableHeadersRow();
+
+        for (const CallLatency* entry : sortBySlowest(entries)) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(latencyDeviceLabel(*entry, gpuStats).c_str());
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(entry->function);
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", entry->calls);
+            ImGui::TableNextColumn();
+            if (entry->errors > 0) {
+                ImGui::TextColored(ImVec4(1.0f, 0.35f, 0.35f, 1.0f), "%llu", entry->errors);
+            } else {
+                ImGui::TextDisabled("0");
+            }
+            ImGui::TableNextColumn();
+            ImGui::TextColored(latencyColor(entry->p50Us), "%s", formatLatency(entry->p50Us).c_str());
+            ImGui::TableNextColumn();
+            ImGui::TextColored(latencyColor(entry->p99Us), "%s", formatLatency(entry->p99Us).c_str());
+            ImGui::TableNextColumn();
+            ImGui::TextColored(latencyColor(entry->maxUs), "%s", formatLatency(entry->maxUs).c_str());
+        }
+        ImGui::EndTable();
+    }
+    ImGui::End();
+}
+
+std::string GpuMonitorUI::formatDiagnosticsText(const std::vector<GpuStats>& gpuStats,
+                                                const SystemInfo& sysInfo) const {
+    std::ostringstream out;
+    out << "NVML Call Latency\n";
+    out << "Device    | Call                                     |    Calls | Errors |      p50 |      p99 |      Max\n";
+    out << "----------+------------------------------------------+----------+--------+----------+----------+---------\n";
+    if (!sysInfo.callLatency) return out.str();
+
+    for (const CallLatency* entry : sortBySlowest(*sysInfo.callLatency)) {
+        char line[192];
+        snprintf(line, sizeof(line), "%-9s | %-40s | %8llu | %6llu | %8s | %8s | %8s\n",
+                 latencyDeviceLabel(*entry, gpuStats).c_str(), entry->function, entry->calls, entry->errors,
+                 formatLatency(entry->p50Us).c_str(), formatLatency(entry->p99Us).c_str(),
+                 formatLatency(entry->maxUs).c_str());
+        out << line;
+    }
+    return out.str();
+}
+
 std::string GpuMonitorUI::formatRecordReportText() const {
     std::ostringstream out;
 
@@ -1689,7 +2345,7 @@ std::string GpuMonitorUI::formatRecordReportText() const {
         << " | Samples: " << m_recording.totalSamples
         << " | GPUs: " << m_recording.gpuData.size() << "\n";
 
-    auto writeTable = [&](const GpuRecordedData& data) {
+    auto writeTable = [&](const GpuRecordedData& data, double gpuSeconds) {
         char line[128];
         out << "Metric           |     Min |     Avg |     Max\n";
         out << "-----------------+---------+---------+--------\n";
@@ -1718,6 +2374,18 @@ std::string GpuMonitorUI::formatRecordReportText() const {
         snprintf(line, sizeof(line), "Mem Clock (MHz)  | %7.0f | %7.0f | %7.0f\n",
             data.memClock.min, data.memClock.avg(), data.memClock.max);
         out << line;
+
+        out << "\nClock limited by |  Seconds |  Share\n";
+        out << "-----------------+----------+-------\n";
+        for (const auto& style : THROTTLE_CAUSE_STYLES) {
+            double sec = data.throttleSeconds[style.cause];
+            snprintf(line, sizeof(line), "%-16s | %8.1f | %5.0f%%\n",
+                style.name, sec, gpuSeconds > 0 ? 100.0 * sec / gpuSeconds : 0.0);
+            out << line;
+        }
+
+        formatEnergy(line, sizeof(line), data.energyJ);
+        out << "\nEnergy: " << line << (data.energyEstimated ? " (estimated from power samples)" : "") << "\n";
     };
 
     // Overall summary (if multiple GPUs)
@@ -1744,9 +2412,14 @@ std::string GpuMonitorUI::formatRecordReportText() const {
             mergeStats(overall.powerDraw, data.powerDraw);
             mergeStats(overall.gpuClock, data.gpuClock);
             mergeStats(overall.memClock, data.memClock);
+            for (size_t cause = 0; cause < THROTTLE_CAUSE_COUNT; cause++) {
+                overall.throttleSeconds[cause] += data.throttleSeconds[cause];
+            }
+            overall.energyJ += data.energyJ;
+            overall.energyEstimated |= data.energyEstimated;
         }
         out << "\n=== OVERALL (" << gpuCount << " GPUs) ===\n";
-        writeTable(overall);
+        writeTable(overall, m_recording.elapsedTime * gpuCount);
     }
 
     // Per-GPU
@@ -1758,7 +2431,7 @@ std::string GpuMonitorUI::formatRecordReportText() const {
             out << " (" << data.displayName << ")";
         }
         out << " ===\n";
-        writeTable(data);
+        writeTable(data, m_recording.elapsedTime);
     }
 
     return out.str();
@@ -1776,11 +2449,11 @@ void GpuMonitorUI::renderBadge(const char* text, bool isTCC) {
 void GpuMonitorUI::renderGpuCard(const GpuStats& stats, const std::vector<GpuStats>& allStats, int index) {
     ImGui::PushID(index);
 
-    GpuCardState& cardState = getCardState(stats.uuid);
+    GpuCardState& cardState = getCardState(stats.device->uuid);
     std::string displayName = getGpuDisplayName(stats);
     bool ctrlHeld = ImGui::GetIO().KeyCtrl;
     bool isDragging = m_dragState.isDragging;
-    bool isBeingDragged = (isDragging && m_dragState.draggedUuid == stats.uuid);
+    bool isBeingDragged = (isDragging && m_dragState.draggedUuid == stats.device->uuid);
 
     // Store card start position
     ImVec2 cardStartPos = ImGui::GetCursorScreenPos();
@@ -1838,14 +2511,14 @@ void GpuMonitorUI::renderGpuCard(const GpuStats& stats, const std::vector<GpuSta
     ImGui::SameLine();
 
     // GPU Name
-    ImGui::Text("%s", stats.name.c_str());
+    ImGui::Text("%s", stats.device->name.c_str());
 
     // Nickname - Ctrl+click to rename (disabled during drag)
     ImGui::SameLine();
     ImGui::TextDisabled("(%s)", displayName.c_str());
 
     // Popup ID for nickname editing
-    std::string popupId = "RenamePopup_" + stats.uuid;
+    std::string popupId = "RenamePopup_" + stats.device->uuid;
 
     // Check if nickname was clicked (only when not dragging)
     if (!isDragging && ImGui::IsItemHovered()) {
@@ -1861,7 +2534,7 @@ void GpuMonitorUI::renderGpuCard(const GpuStats& stats, const std::vector<GpuSta
 
     // Nickname rename popup
     if (ImGui::BeginPopup(popupId.c_str())) {
-        GpuConfig* config = getOrCreateGpuConfig(stats.uuid);
+        GpuConfig* config = getOrCreateGpuConfig(stats.device->uuid);
         if (config) {
             ImGui::Text(ICON_FA_PEN " Rename GPU:");
             ImGui::SetNextItemWidth(200);
@@ -1888,15 +2561,84 @@ void GpuMonitorUI::renderGpuCard(const GpuStats& stats, const std::vector<GpuSta
     }
 
 #ifdef _WIN32
-    renderBadge(stats.isTCC ? "TCC" : "WDDM", stats.isTCC);
+    renderBadge(stats.device->isTCC ? "TCC" : "WDDM", stats.device->isTCC);
 #else
     renderBadge(stats.persistenceMode ? "Persist" : "No Persist", stats.persistenceMode);
 #endif
     ImGui::SameLine();
-    ImGui::TextDisabled("cuda:%u", stats.cudaIndex);
+    ImGui::TextDisabled("cuda:%u", stats.device->cudaIndex);
+
+    // Lost devices stay on the board with their last readings
+    if (stats.gone) {
+        ImGui::SameLine();
+        ImGui::TextColored(ImVec4(1.0f, 0.35f, 0.35f, 1.0f), ICON_FA_PLUG_CIRCLE_XMARK " Lost");
+        if (ImGui::IsItemHovered()) {
+            ImGui::SetTooltip("The driver no longer reports this GPU (fell off the bus, reset or removed).\n"
+                              "Readings are the last ones taken before it went.");
+        }
+    }
+
+    // Data age: time since this device was last collected. Fresh data stays dim; a stalled
+    // poller or hung driver call shows up in amber.
+    if (stats.captured.steadyUs > 0) {
+        constexpr long long STALE_AGE_US = 2000000;
+        long long ageUs = std::max(0LL, CaptureTime::now().steadyUs - stats.captured.steadyUs);
+        char ageText[32];
+        if (ageUs < 1000000) {
+            snprintf(ageText, sizeof(ageText), ICON_FA_CLOCK " %lld ms", ageUs / 1000);
+        } else {
+            snprintf(ageText, sizeof(ageText), ICON_FA_CLOCK " %.1f s", ageUs / 1e6);
+        }
+        ImGui::SameLine();
+        if (ageUs >= STALE_AGE_US) {
+            ImGui::TextColored(ImVec4(1.0f, 0.7f, 0.3f, 1.0f), "%s", ageText);
+        } else {
+            ImGui::TextDisabled("%s", ageText);
+        }
+        if (ImGui::IsItemHovered()) {
+            static const char* groupNames[METRIC_GROUP_COUNT] = {"Utilization/power", "Thermal/clocks",
+                                                                  "Memory/processes", "Health"};
+            ImGui::BeginTooltip();
+            ImGui::Text("Driver queries took %.2f ms", stats.captured.durationUs / 1000.0f);
+            ImGui::Text("Polling every %u ms", stats.pollIntervalMs);
+            for (int group = 0; group < METRIC_GROUP_COUNT; group++) {
+                ImGui::TextDisabled("%s: %.1f s old", groupNames[group],
+                                    (stats.groupAgeMs[group] * 1000LL + ageUs) / 1e6);
+            }
+            ImGui::EndTooltip();
+        }
+    }
+
+    // Driver-reported errors (XID, ECC) since the monitor started
+    if (!stats.events.empty()) {
+        const GpuEvent& latest = stats.events.back();
+        ImGui::SameLine();
+        if (latest.type == EVENT_XID) {
+            ImGui::TextColored(ImVec4(1.0f, 0.35f, 0.35f, 1.0f), ICON_FA_TRIANGLE_EXCLAMATION " XID %llu", latest.data);
+        } else {
+            ImGui::TextColored(ImVec4(1.0f, 0.35f, 0.35f, 1.0f), ICON_FA_TRIANGLE_EXCLAMATION " ECC");
+        }
+        if (ImGui::IsItemHovered()) {
+            long long nowUs = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+            ImGui::BeginTooltip();
+            for (auto it = stats.events.rbegin(); it != stats.events.rend(); ++it) {
+                double agoSec = static_cast<double>(nowUs - it->timestampUs) / 1e6;
+                switch (it->type) {
+                    case EVENT_XID:            ImGui::Text("XID %llu", it->data); break;
+                    case EVENT_ECC_SINGLE_BIT: ImGui::Text("Correctable ECC error"); break;
+                    case EVENT_ECC_DOUBLE_BIT: ImGui::Text("Uncorrectable ECC error"); break;
+                    default:                   ImGui::Text("Clock change"); break;
+                }
+                ImGui::SameLine();
+                ImGui::TextDisabled("%.0fs ago", agoSec);
+            }
+            ImGui::EndTooltip();
+        }
+    }
 
     // Get or create GPU config for persistent state
-    GpuConfig* gpuConfig = getOrCreateGpuConfig(stats.uuid);
+    GpuConfig* gpuConfig = getOrCreateGpuConfig(stats.device->uuid);
 
     // Collapse/Expand button (right-aligned)
     ImGui::SameLine(ImGui::GetContentRegionAvail().x - 20);
@@ -1914,17 +2656,47 @@ void GpuMonitorUI::renderGpuCard(const GpuStats& stats, const std::vector<GpuSta
     float vramUsedGB = static_cast<float>(stats.vramUsed) / (1024.0f * 1024.0f * 1024.0f);
     float vramTotalGB = static_cast<float>(stats.vramTotal) / (1024.0f * 1024.0f * 1024.0f);
     float vramFrac = vramTotalGB > 0 ? vramUsedGB / vramTotalGB : 0.0f;
-    float gpuUtilFrac = stats.gpuUtilization / 100.0f;
-    float powerFrac = stats.powerLimit > 0 ? static_cast<float>(stats.powerDraw) / stats.powerLimit : 0.0f;
-    float coreClockFrac = stats.gpuClockMax > 0 ? static_cast<float>(stats.gpuClock) / stats.gpuClockMax : 0.0f;
-    float memClockFrac = stats.memClockMax > 0 ? static_cast<float>(stats.memClock) / stats.memClockMax : 0.0f;
     float tempFrac = stats.temperature / 100.0f;
     float fanFrac = stats.fanSpeed / 100.0f;
 
+    // Driver sample buffers are finer than the poll: the gauge and its label show the
+    // newest driver sample rather than the poll average
+    const auto& gpuUtilTrace = stats.traces[TRACE_GPU_UTILIZATION];
+    float gpuUtilNow = gpuUtilTrace.empty() ? static_cast<float>(stats.gpuUtilization) : gpuUtilTrace.back().value;
+    float gpuUtilFrac = gpuUtilNow / 100.0f;
+    const auto& memUtilTrace = stats.traces[TRACE_MEM_UTILIZATION];
+    float memUtilNow = memUtilTrace.empty() ? static_cast<float>(stats.memUtilization) : memUtilTrace.back().value;
+    float memUtilFrac = memUtilNow / 100.0f;
+
+    double pcieMax = pcieBandwidth(stats.pcieGen, stats.pcieWidth);
+    float pcieTxFrac = pcieMax > 0 ? static_cast<float>(stats.pcieRate.txBytesPerSec / pcieMax) : 0.0f;
+    float pcieRxFrac = pcieMax > 0 ? static_cast<float>(stats.pcieRate.rxBytesPerSec / pcieMax) : 0.0f;
+    float nvlinkRate = static_cast<float>(stats.nvlinkRate.txBytesPerSec + stats.nvlinkRate.rxBytesPerSec);
+    unsigned int clockEvents = static_cast<unsigned int>(stats.clockEventReasons);
+    double energyJ = stats.energyMj / 1000.0;
+    float smActivityFrac = static_cast<float>(stats.gpm.smActivity / 100.0);
+    float tensorFrac = static_cast<float>(stats.gpm.tensorActivity / 100.0);
+    float dramFrac = static_cast<float>(stats.gpm.dramBandwidth / 100.0);
+
     // Always track history even when collapsed
-    GpuMetricHistory& history = m_metricHistory[stats.uuid];
-    float deltaTime = ImGui::GetIO().DeltaTime;
-    history.addSample(deltaTime, vramFrac, gpuUtilFrac, powerFrac, coreClockFrac, memClockFrac, tempFrac, fanFrac);
+    GpuMetricHistory& history = m_metricHistory[stats.device->uuid];
+    history.addSample(stats.captured.steadyUs, vramFrac, tempFrac, fanFrac, pcieTxFrac, pcieRxFrac,
+                      nvlinkRate, clockEvents, energyJ, smActivityFrac, tensorFrac, dramFrac);
+
+    // Every driver sample goes into the history at its own time
+    float powerScale = stats.powerLimit > 0 ? 1.0f / stats.powerLimit : 0.0f;
+    float coreClockScale = stats.device->gpuClockMax > 0 ? 1.0f / stats.device->gpuClockMax : 0.0f;
+    float memClockScale = stats.device->memClockMax > 0 ? 1.0f / stats.device->memClockMax : 0.0f;
+    GpuMetricHistory::addTrace(history.gpuUtilHistory, gpuUtilTrace, static_cast<float>(stats.gpuUtilization),
+                               1.0f / 100.0f, stats.captured);
+    GpuMetricHistory::addTrace(history.memUtilHistory, memUtilTrace, static_cast<float>(stats.memUtilization),
+                               1.0f / 100.0f, stats.captured);
+    GpuMetricHistory::addTrace(history.powerHistory, stats.traces[TRACE_POWER], stats.powerDrawMw / 1000.0f,
+                               powerScale, stats.captured);
+    GpuMetricHistory::addTrace(history.coreClockHistory, stats.traces[TRACE_GPU_CLOCK],
+                               static_cast<float>(stats.gpuClock), coreClockScale, stats.captured);
+    GpuMetricHistory::addTrace(history.memClockHistory, stats.traces[TRACE_MEM_CLOCK],
+                               static_cast<float>(stats.memClock), memClockScale, stats.captured);
 
     // Collapsed view: compact visual indicators in a single row
     if (!gpuConfig->cardOpen) {
@@ -1975,7 +2747,7 @@ void GpuMonitorUI::renderGpuCard(const GpuStats& stats, const std::vector<GpuSta
             IM_COL32(50, 50, 55, 255), 2.0f);
         curX += barWidth + 3.0f;
         char gpuStr[16];
-        snprintf(gpuStr, sizeof(gpuStr), "%u%%", stats.gpuUtilization);
+        snprintf(gpuStr, sizeof(gpuStr), "%.0f%%", gpuUtilNow);
         drawList->AddText(ImVec2(curX, startPos.y), gpuColor, gpuStr);
         curX += ImGui::CalcTextSize(gpuStr).x + 10.0f;
 
@@ -2039,10 +2811,7 @@ void GpuMonitorUI::renderGpuCard(const GpuStats& stats, const std::vector<GpuSta
     ImGui::Separator();
     ImGui::Spacing();
 
-    int displaySecs = history.displaySeconds;
-    if (m_zoomState.isDragging && m_zoomState.dragGpuUuid == stats.uuid) {
-        displaySecs = m_zoomState.previewDisplaySeconds;
-    }
+    int displaySecs = displaySecondsFor(stats.device->uuid);
 
     // Health colors (3-level for Power/Core/Mem)
     ImVec4 healthColors[] = {
@@ -2066,15 +2835,15 @@ void GpuMonitorUI::renderGpuCard(const GpuStats& stats, const std::vector<GpuSta
     };
 
     // Get history data
-    float vramData[GpuMetricHistory::HISTORY_SIZE];
-    float gpuUtilData[GpuMetricHistory::HISTORY_SIZE];
+    float vramData[GpuMetricHistory::PLOT_POINTS];
+    float gpuUtilData[GpuMetricHistory::PLOT_POINTS];
+    float memUtilData[GpuMetricHistory::PLOT_POINTS];
     size_t dataCount = 0;
 
-    int savedDisplaySecs = history.displaySeconds;
-    history.displaySeconds = displaySecs;
-    history.getOrderedMetric(history.vramHistory, vramData, dataCount);
-    history.getOrderedMetric(history.gpuUtilHistory, gpuUtilData, dataCount);
-    history.displaySeconds = savedDisplaySecs;
+    long long nowUs = CaptureTime::now().steadyUs;
+    history.getOrderedMetric(history.vramHistory, vramData, dataCount, nowUs, displaySecs);
+    history.getOrderedMetric(history.gpuUtilHistory, gpuUtilData, dataCount, nowUs, displaySecs);
+    history.getOrderedMetric(history.memUtilHistory, memUtilData, dataCount, nowUs, displaySecs);
 
     // Layout dimensions - must match compact metrics margins
     float availableWidth = ImGui::GetContentRegionAvail().x;
@@ -2086,7 +2855,7 @@ void GpuMonitorUI::renderGpuCard(const GpuStats& stats, const std::vector<GpuSta
     float headerHeight = ImGui::GetTextLineHeight() + 4.0f;
 
     bool canInteract = !m_dragState.isDragging;
-    bool isThisGpuZooming = m_zoomState.isDragging && m_zoomState.dragGpuUuid == stats.uuid;
+    bool isThisGpuZooming = m_zoomState.isDragging && m_zoomState.dragGpuUuid == stats.device->uuid;
     bool anyVramGpuHovered = false;
 
     ImDrawList* drawList = ImGui::GetWindowDrawList();
@@ -2174,7 +2943,7 @@ void GpuMonitorUI::renderGpuCard(const GpuStats& stats, const std::vector<GpuSta
     char vramValueStr[64];
     snprintf(vramValueStr, sizeof(vramValueStr), "%.1f/%.0fGB (%d%%) | %.1fGB free",
              vramUsedGB, vramTotalGB, vramPercent, vramAvailGB);
-    std::string vramSparkId = "##spark_vram_" + stats.uuid;
+    std::string vramSparkId = "##spark_vram_" + stats.device->uuid;
     if (renderFullWidthMetric("VRAM", vramValueStr, vramFrac,
                                vramData, dataCount, vramSparkId.c_str(), true)) {
         anyVramGpuHovered = true;
@@ -2182,18 +2951,27 @@ void GpuMonitorUI::renderGpuCard(const GpuStats& stats, const std::vector<GpuSta
 
     // GPU Utilization
     char gpuValueStr[16];
-    snprintf(gpuValueStr, sizeof(gpuValueStr), "%u%%", stats.gpuUtilization);
-    std::string gpuSparkId = "##spark_gpuutil_" + stats.uuid;
+    snprintf(gpuValueStr, sizeof(gpuValueStr), "%.0f%%", gpuUtilNow);
+    std::string gpuSparkId = "##spark_gpuutil_" + stats.device->uuid;
     if (renderFullWidthMetric("GPU", gpuValueStr, gpuUtilFrac,
                                gpuUtilData, dataCount, gpuSparkId.c_str(), true)) {
         anyVramGpuHovered = true;
     }
 
+    // Memory controller utilization (time device memory was being read or written)
+    char memUtilValueStr[16];
+    snprintf(memUtilValueStr, sizeof(memUtilValueStr), "%.0f%%", memUtilNow);
+    std::string memUtilSparkId = "##spark_memutil_" + stats.device->uuid;
+    if (renderFullWidthMetric("Mem Util", memUtilValueStr, memUtilFrac,
+                               memUtilData, dataCount, memUtilSparkId.c_str(), true)) {
+        anyVramGpuHovered = true;
+    }
+
     // Handle zoom drag interaction for VRAM/GPU sparklines
     if (canInteract) {
         if (anyVramGpuHovered && ImGui::IsMouseClicked(ImGuiMouseButton_Left)) {
             m_zoomState.isDragging = true;
-            m_zoomState.dragGpuUuid = stats.uuid;
+            m_zoomState.dragGpuUuid = stats.device->uuid;
             m_zoomState.dragStartX = ImGui::GetMousePos().x;
             m_zoomState.originalDisplaySeconds = history.displaySeconds;
             m_zoomState.previewDisplaySeconds = history.displaySeconds;
@@ -2209,7 +2987,7 @@ void GpuMonitorUI::renderGpuCard(const GpuStats& stats, const std::vector<GpuSta
     }
 
     // Handle ongoing zoom drag
-    if (m_zoomState.isDragging && m_zoomState.dragGpuUuid == stats.uuid) {
+    if (m_zoomState.isDragging && m_zoomState.dragGpuUuid == stats.device->uuid) {
         float deltaX = ImGui::GetMousePos().x - m_zoomState.dragStartX;
         int deltaSecs = static_cast<int>(deltaX / 2.0f);
         int newSecs = m_zoomState.originalDisplaySeconds + deltaSecs;
@@ -2244,8 +3022,15 @@ void GpuMonitorUI::renderGpuCard(const GpuStats& stats, const std::vector<GpuSta
         }
     }
 
-    // Compact metrics with sparklines (Power, Core, Memory)
+    // Compact metrics with sparklines (Power, Core, Memory), then interconnect throughput
+    // on devices that report traffic counters
     renderCompactMetrics(stats);
+    if (stats.pcieTxBytes != 0 || stats.pcieRxBytes != 0 || !stats.nvlinkLinkBytes.empty()) {
+        renderInterconnectMetrics(stats);
+    }
+    if (stats.gpm.valid) {
+        renderProfilingMetrics(stats);
+    }
 
     ImGui::Spacing();
 
@@ -2283,9 +3068,19 @@ void GpuMonitorUI::renderGpuCard(const GpuStats& stats, const std::vector<GpuSta
             IM_COL32(60, 60, 65, 255), 2.0f);
         curX += barWidth + 3.0f;
 
-        char tempStr[16];
-        snprintf(tempStr, sizeof(tempStr), "%uC", stats.temperature);
+        char tempStr[32];
+        if (stats.memTemperature > 0) {
+            // HBM boards also report memory temperature
+            snprintf(tempStr, sizeof(tempStr), "%uC / %uC", stats.temperature, stats.memTemperature);
+        } else {
+            snprintf(tempStr, sizeof(tempStr), "%uC", stats.temperature);
+        }
         drawList->AddText(ImVec2(curX, startPos.y), tempColorU32, tempStr);
+        if (stats.memTemperature > 0 &&
+            ImGui::IsMouseHoveringRect(ImVec2(curX, startPos.y),
+                ImVec2(curX + ImGui::CalcTextSize(tempStr).x, startPos.y + rowHeight))) {
+            ImGui::SetTooltip("GPU %uC, memory %uC", stats.temperature, stats.memTemperature);
+        }
         curX += ImGui::CalcTextSize(tempStr).x + 14.0f;
 
         // Fan: Label + Donut + Value
@@ -2321,7 +3116,7 @@ void GpuMonitorUI::renderGpuCard(const GpuStats& stats, const std::vector<GpuSta
         char pcieStr[16];
         snprintf(pcieStr, sizeof(pcieStr), "Gen%u x%u", stats.pcieGen, stats.pcieWidth);
         ImVec2 pcieSize = ImGui::CalcTextSize(pcieStr);
-        ImVec2 busSize = ImGui::CalcTextSize(stats.pciBusId.c_str());
+        ImVec2 busSize = ImGui::CalcTextSize(stats.device->pciBusId.c_str());
 
         float rightMargin = 8.0f;
         float gap = 10.0f;
@@ -2329,7 +3124,7 @@ void GpuMonitorUI::renderGpuCard(const GpuStats& stats, const std::vector<GpuSta
 
         // Bus ID (rightmost, dimmed)
         float busX = rightX - busSize.x;
-        drawList->AddText(ImVec2(busX, startPos.y), IM_COL32(90, 90, 90, 255), stats.pciBusId.c_str());
+        drawList->AddText(ImVec2(busX, startPos.y), IM_COL32(90, 90, 90, 255), stats.device->pciBusId.c_str());
 
         // PCIe (to the left of Bus)
         float pcieX = busX - gap - pcieSize.x;
@@ -2341,6 +3136,10 @@ void GpuMonitorUI::renderGpuCard(const GpuStats& stats, const std::vector<GpuSta
 
     ImGui::Spacing();
 
+    if (!stats.migInstances.empty()) {
+        renderMigInstances(stats);
+    }
+
     // Processes section (collapsible) - disabled during drag
     std::string procHeader = std::string(ICON_FA_GEARS) + " Processes (" + std::to_string(stats.processes.size()) + ")";
     if (isDragging) {
@@ -2406,7 +3205,7 @@ void GpuMonitorUI::renderCommandsSection(const GpuStats& stats, const std::vecto
 
     // Use only this GPU
     {
-        std::string idx = std::to_string(stats.cudaIndex);
+        std::string idx = std::to_string(stats.device->cudaIndex);
 #ifdef _WIN32
         std::string cmd = "$env:CUDA_VISIBLE_DEVICES=\"" + idx + "\"";
 #else
@@ -2421,11 +3220,11 @@ void GpuMonitorUI::renderCommandsSection(const GpuStats& stats, const std::vecto
             openTerminalWithGpu(idx, displayName);
         }
         ImGui::SameLine();
-        ImGui::TextDisabled("cuda:%u", stats.cudaIndex);
+        ImGui::TextDisabled("cuda:%u", stats.device->cudaIndex);
     }
 
     // Use TCC/Compute GPUs (show for TCC GPUs - typically NVLink capable)
-    if (stats.isTCC) {
+    if (stats.device->isTCC) {
         std::string tccIndices = buildNvlinkPair(allStats);
         if (!tccIndices.empty() && tccIndices.find(',') != std::string::npos) {
             // Only show if there are multiple TCC GPUs
@@ -2449,7 +3248,7 @@ void GpuMonitorUI::renderCommandsSection(const GpuStats& stats, const std::vecto
 
     // Exclude this GPU
     {
-        std::string otherIndices = buildExcludeDevices(allStats, stats.cudaIndex);
+        std::string otherIndices = buildExcludeDevices(allStats, stats.device->cudaIndex);
 #ifdef _WIN32
         std::string cmd = "$env:CUDA_VISIBLE_DEVICES=\"" + otherIndices + "\"";
 #else
@@ -2467,6 +3266,29 @@ void GpuMonitorUI::renderCommandsSection(const GpuStats& stats, const std::vecto
         ImGui::TextDisabled("cuda:%s", otherIndices.c_str());
     }
 
+    // One MIG instance: CUDA only accepts these by UUID
+    for (const auto& instance : stats.migInstances) {
+        ImGui::PushID(instance.uuid.c_str());
+#ifdef _WIN32
+        std::string cmd = "$env:CUDA_VISIBLE_DEVICES=\"" + instance.uuid + "\"";
+#else
+        std::string cmd = "export CUDA_VISIBLE_DEVICES=" + instance.uuid;
+#endif
+        std::string profile = migProfileName(instance);
+        if (ImGui::Button((ICON_FA_TABLE_CELLS " Use MIG " + profile + " (GI " +
+                           std::to_string(instance.gpuInstanceId) + ")").c_str())) {
+            copyToClipboard(cmd);
+            showCopiedToast("CUDA_VISIBLE_DEVICES");
+        }
+        ImGui::SameLine();
+        if (ImGui::SmallButton(ICON_FA_TERMINAL "##mig")) {
+            openTerminalWithGpu(instance.uuid, displayName + " MIG " + profile);
+        }
+        ImGui::SameLine();
+        ImGui::TextDisabled("%s", instance.uuid.c_str());
+        ImGui::PopID();
+    }
+
     ImGui::Spacing();
     ImGui::Separator();
     ImGui::Spacing();
@@ -2476,20 +3298,20 @@ void GpuMonitorUI::renderCommandsSection(const GpuStats& stats, const std::vecto
     ImGui::Spacing();
 
     if (ImGui::Button(ICON_FA_CLIPBOARD " Bus ID")) {
-        copyToClipboard(stats.pciBusId);
+        copyToClipboard(stats.device->pciBusId);
         showCopiedToast("Bus ID");
     }
     ImGui::SameLine();
 
     if (ImGui::Button(ICON_FA_CLIPBOARD " CUDA Index")) {
-        copyToClipboard(std::to_string(stats.cudaIndex));
+        copyToClipboard(std::to_string(stats.device->cudaIndex));
         showCopiedToast("CUDA Index");
     }
     ImGui::SameLine();
 
     // nvidia-smi for this GPU
     {
-        std::string cmd = "nvidia-smi -i " + std::to_string(stats.cudaIndex);
+        std::string cmd = "nvidia-smi -i " + std::to_string(stats.device->cudaIndex);
         if (ImGui::Button(ICON_FA_GAUGE " nvidia-smi")) {
             copyToClipboard(cmd);
             showCopiedToast("nvidia-smi command");
@@ -2507,17 +3329,17 @@ void GpuMonitorUI::renderCommandsSection(const GpuStats& stats, const std::vecto
 #ifdef _WIN32
     // Toggle TCC/WDDM (Windows only)
     {
-        std::string targetMode = stats.isTCC ? "WDDM" : "TCC";
-        std::string currentMode = stats.isTCC ? "TCC" : "WDDM";
-        int modeValue = stats.isTCC ? 0 : 1;
-        std::string cmd = "nvidia-smi -i " + std::to_string(stats.cudaIndex) + " -dm " + std::to_string(modeValue);
+        std::string targetMode = stats.device->isTCC ? "WDDM" : "TCC";
+        std::string currentMode = stats.device->isTCC ? "TCC" : "WDDM";
+        int modeValue = stats.device->isTCC ? 0 : 1;
+        std::string cmd = "nvidia-smi -i " + std::to_string(stats.device->cudaIndex) + " -dm " + std::to_string(modeValue);
 
         std::string btnLabel = "Switch to " + targetMode;
         if (ImGui::Button(btnLabel.c_str())) {
             m_confirmDialog.isOpen = true;
             m_confirmDialog.isDangerous = true;
             m_confirmDialog.title = "Toggle Driver Mode";
-            m_confirmDialog.message = "This will switch GPU " + std::to_string(stats.cudaIndex) +
+            m_confirmDialog.message = "This will switch GPU " + std::to_string(stats.device->cudaIndex) +
                 " (" + displayName + ") from " + currentMode + " to " + targetMode + " mode.\n\n"
                 "A system restart is required for this change to take effect.";
             m_confirmDialog.command = cmd;
@@ -2529,7 +3351,7 @@ void GpuMonitorUI::renderCommandsSection(const GpuStats& stats, const std::vecto
     {
         std::string targetState = stats.persistenceMode ? "Disable" : "Enable";
         int modeValue = stats.persistenceMode ? 0 : 1;
-        std::string cmd = "nvidia-smi -i " + std::to_string(stats.cudaIndex) + " -pm " + std::to_string(modeValue);
+        std::string cmd = "nvidia-smi -i " + std::to_string(stats.device->cudaIndex) + " -pm " + std::to_string(modeValue);
 
         std::string btnLabel = targetState + " Persistence";
         if (ImGui::Button(btnLabel.c_str())) {
@@ -2537,7 +3359,7 @@ void GpuMonitorUI::renderCommandsSection(const GpuStats& stats, const std::vecto
             m_confirmDialog.isDangerous = false;
             m_confirmDialog.title = "Toggle Persistence Mode";
             m_confirmDialog.message = "This will " + targetState + " persistence mode for GPU " +
-                std::to_string(stats.cudaIndex) + " (" + displayName + ").\n\n"
+                std::to_string(stats.device->cudaIndex) + " (" + displayName + ").\n\n"
                 "When enabled, the NVIDIA driver stays loaded even with no active clients, "
                 "reducing startup latency for CUDA programs.";
             m_confirmDialog.command = cmd;
@@ -2548,12 +3370,12 @@ void GpuMonitorUI::renderCommandsSection(const GpuStats& stats, const std::vecto
 
     // Reset GPU
     {
-        std::string cmd = "nvidia-smi -i " + std::to_string(stats.cudaIndex) + " --gpu-reset";
+        std::string cmd = "nvidia-smi -i " + std::to_string(stats.device->cudaIndex) + " --gpu-reset";
         if (ImGui::Button(ICON_FA_ROTATE " Reset GPU")) {
             m_confirmDialog.isOpen = true;
             m_confirmDialog.isDangerous = true;
             m_confirmDialog.title = "Reset GPU";
-            m_confirmDialog.message = "This will reset GPU " + std::to_string(stats.cudaIndex) +
+            m_confirmDialog.message = "This will reset GPU " + std::to_string(stats.device->cudaIndex) +
                 " (" + displayName + ").\n\nAll running processes on this GPU will be terminated.";
             m_confirmDialog.command = cmd;
         }
@@ -2567,14 +3389,14 @@ void GpuMonitorUI::renderCommandsSection(const GpuStats& stats, const std::vecto
     for (int i = 0; i < 3; i++) {
         unsigned int watts = powerPresets[i];
         std::string label = std::to_string(watts) + "W";
-        std::string cmd = "nvidia-smi -i " + std::to_string(stats.cudaIndex) + " -pl " + std::to_string(watts);
+        std::string cmd = "nvidia-smi -i " + std::to_string(stats.device->cudaIndex) + " -pl " + std::to_string(watts);
 
         if (i > 0) ImGui::SameLine();
         if (ImGui::SmallButton(label.c_str())) {
             m_confirmDialog.isOpen = true;
             m_confirmDialog.isDangerous = true;
             m_confirmDialog.title = "Set Power Limit";
-            m_confirmDialog.message = "This will set the power limit for GPU " + std::to_string(stats.cudaIndex) +
+            m_confirmDialog.message = "This will set the power limit for GPU " + std::to_string(stats.device->cudaIndex) +
                 " (" + displayName + ") to " + std::to_string(watts) + "W.";
             m_confirmDialog.command = cmd;
         }
@@ -2583,11 +3405,11 @@ void GpuMonitorUI::renderCommandsSection(const GpuStats& stats, const std::vecto
     // Kill processes on this GPU
     {
 #ifdef _WIN32
-        std::string cmd = "(nvidia-smi -i " + std::to_string(stats.cudaIndex) +
+        std::string cmd = "(nvidia-smi -i " + std::to_string(stats.device->cudaIndex) +
             " --query-compute-apps=pid --format=csv,noheader) | "
             "ForEach-Object { Stop-Process -Id $_ -Force }";
 #else
-        std::string cmd = "nvidia-smi -i " + std::to_string(stats.cudaIndex) +
+        std::string cmd = "nvidia-smi -i " + std::to_string(stats.device->cudaIndex) +
             " --query-compute-apps=pid --format=csv,noheader | xargs -r kill -9";
 #endif
 
@@ -2596,7 +3418,7 @@ void GpuMonitorUI::renderCommandsSection(const GpuStats& stats, const std::vecto
             m_confirmDialog.isDangerous = true;
             m_confirmDialog.title = "Kill GPU Processes";
             m_confirmDialog.message = "This will forcefully terminate ALL processes running on GPU " +
-                std::to_string(stats.cudaIndex) + " (" + displayName + ").\n\n"
+                std::to_string(stats.device->cudaIndex) + " (" + displayName + ").\n\n"
                 "This may cause data loss in running applications!";
             m_confirmDialog.command = cmd;
         }
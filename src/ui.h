@@ -2,12 +2,16 @@
 
 #include "gpu_monitor.h"
 #include "imgui.h"
+#include <array>
 #include <vector>
 #include <string>
 #include <map>
+#include <memory>
 #include <functional>
 #include <algorithm>
 #include <limits>
+#include <span>
+#include <type_traits>
 #include <sstream>
 
 // Confirmation dialog state
@@ -68,74 +72,219 @@ struct GpuCardState {
 
 // History buffer for sparklines (circular buffer)
 struct GpuMetricHistory {
-    // Buffer holds 36000 samples. At 60fps = 10 minutes; at 600fps = 1 minute
-    // Actual sample rate is auto-detected and used for time calculations
+    // One slot per captured sample, stamped with its capture time. At the default 100 ms
+    // tick the buffer spans an hour; display windows are resolved by time, not slot count.
     static constexpr size_t HISTORY_SIZE = 36000;
+    static constexpr size_t PLOT_POINTS = 600;  // Points per sparkline, evenly spaced in time
     static constexpr int DEFAULT_DISPLAY_SECONDS = 60;
     static constexpr int MIN_DISPLAY_SECONDS = 5;
     static constexpr int MAX_DISPLAY_SECONDS = 600;
 
+    // A metric the driver also samples between polls. Every driver sample is kept at its
+    // own timestamp, with the poll value standing in when the driver reports none, so a
+    // slow poll still plots at the driver's resolution. Sized for the longest display
+    // window at 25 samples/s; denser driver buffers shorten the span that is kept.
+    struct TracedSeries {
+        static constexpr size_t SIZE = MAX_DISPLAY_SECONDS * 25;
+
+        std::unique_ptr<float[]> values = std::make_unique<float[]>(SIZE);
+        std::unique_ptr<long long[]> timeUs = std::make_unique<long long[]>(SIZE);  // Steady clock
+        size_t writeIndex = 0;
+        size_t count = 0;
+
+        // Samples at or before the newest one (seen on an earlier frame) are ignored
+        void add(long long us, float value) {
+            if (count > 0 && us <= timeUs[(writeIndex + SIZE - 1) % SIZE]) return;
+            values[writeIndex] = value;
+            timeUs[writeIndex] = us;
+            writeIndex = (writeIndex + 1) % SIZE;
+            count = std::min(count + 1, SIZE);
+        }
+    };
+
     // All metrics as fractions (0-1)
     float vramHistory[HISTORY_SIZE] = {};       // VRAM usage fraction
-    float gpuUtilHistory[HISTORY_SIZE] = {};    // GPU utilization fraction
-    float powerHistory[HISTORY_SIZE] = {};      // Power as fraction of limit
-    float coreClockHistory[HISTORY_SIZE] = {};  // Core clock as fraction of max
-    float memClockHistory[HISTORY_SIZE] = {};   // Mem clock as fraction of max
     float tempHistory[HISTORY_SIZE] = {};       // Temperature as fraction (0-100C mapped to 0-1)
     float fanHistory[HISTORY_SIZE] = {};        // Fan speed as fraction (0-100%)
+    long long timeUs[HISTORY_SIZE] = {};        // Capture time of each slot (steady clock)
+    TracedSeries gpuUtilHistory;                // GPU utilization fraction
+    TracedSeries memUtilHistory;                // Memory controller utilization fraction
+    TracedSeries powerHistory;                  // Power as fraction of limit
+    TracedSeries coreClockHistory;              // Core clock as fraction of max
+    TracedSeries memClockHistory;               // Mem clock as fraction of max
+
+    // Metrics many GPUs never report. Each buffer is allocated on its first non-zero
+    // sample; until then it is null and reads as all zero.
+    std::unique_ptr<float[]> pcieTxHistory;     // PCIe TX as fraction of the link's current peak
+    std::unique_ptr<float[]> pcieRxHistory;     // PCIe RX as fraction of the link's current peak
+    std::unique_ptr<float[]> nvlinkHistory;     // NVLink TX + RX, bytes/s (scaled when plotted)
+    std::unique_ptr<unsigned int[]> clockEventHistory;  // ClockEventReason bits
+    std::unique_ptr<double[]> energyHistory;    // Energy counter, joules (0 = not reported)
+    std::unique_ptr<float[]> smActivityHistory; // GPM SM activity fraction (0 without GPM)
+    std::unique_ptr<float[]> tensorHistory;     // GPM tensor pipe activity fraction
+    std::unique_ptr<float[]> dramHistory;       // GPM DRAM bandwidth fraction of peak
 
     size_t writeIndex = 0;
     size_t sampleCount = 0;  // How many samples we've collected (up to HISTORY_SIZE)
     int displaySeconds = DEFAULT_DISPLAY_SECONDS;  // How many seconds to show (zoom level)
-    float totalElapsedTime = 0.0f;  // Total time since first sample (for calculating sample rate)
-
-    // Add a sample every frame - tracks elapsed time to calculate actual sample rate
-    void addSample(float deltaTime, float vram, float gpuUtil, float power,
-                   float coreClock, float memClock, float temp, float fan) {
-        // Only accumulate time while buffer is filling (not yet wrapped)
-        // Once full, the ratio sampleCount/totalElapsedTime is locked to actual rate
-        if (sampleCount < HISTORY_SIZE) {
-            totalElapsedTime += deltaTime;
-            sampleCount++;
-        }
+
+    // Append a captured sample. Samples at or before the newest slot (the same capture
+    // seen on another frame) are ignored, so the frame rate has no effect on the history.
+    // Traced metrics are added separately (addTrace).
+    void addSample(long long capturedUs, float vram, float temp, float fan,
+                   float pcieTx, float pcieRx, float nvlink, unsigned int clockEvents, double energy,
+                   float smActivity, float tensor, float dram) {
+        if (sampleCount > 0 && capturedUs <= newestUs()) return;
 
         vramHistory[writeIndex] = vram;
-        gpuUtilHistory[writeIndex] = gpuUtil;
-        powerHistory[writeIndex] = power;
-        coreClockHistory[writeIndex] = coreClock;
-        memClockHistory[writeIndex] = memClock;
         tempHistory[writeIndex] = temp;
         fanHistory[writeIndex] = fan;
+        store(pcieTxHistory, pcieTx);
+        store(pcieRxHistory, pcieRx);
+        store(nvlinkHistory, nvlink);
+        store(clockEventHistory, clockEvents);
+        store(energyHistory, energy);
+        store(smActivityHistory, smActivity);
+        store(tensorHistory, tensor);
+        store(dramHistory, dram);
+        timeUs[writeIndex] = capturedUs;
         writeIndex = (writeIndex + 1) % HISTORY_SIZE;
+        sampleCount = std::min(sampleCount + 1, HISTORY_SIZE);
+    }
+
+    // Add a poll's driver samples to a traced metric, each at its own time (driver
+    // timestamps are wall-clock and are moved onto the steady clock of `captured`). With
+    // no driver samples, the poll value is added at the capture time instead.
+    static void addTrace(TracedSeries& series, const std::vector<TimedValue>& trace, float pollValue,
+                         float scale, const CaptureTime& captured) {
+        if (trace.empty()) {
+            series.add(captured.steadyUs, pollValue * scale);
+            return;
+        }
+        long long wallToSteadyUs = captured.wallUs - captured.steadyUs;
+        for (const auto& sample : trace) {
+            series.add(sample.timestampUs - wallToSteadyUs, sample.value * scale);
+        }
+    }
+
+    // Write an optional metric's slot, allocating its buffer on the first non-zero value
+    template <typename T>
+    void store(std::unique_ptr<T[]>& series, T value) {
+        if (!series) {
+            if (value == T{}) return;
+            series = std::make_unique<T[]>(HISTORY_SIZE);
+        }
+        series[writeIndex] = value;
     }
 
-    // Get effective samples per second based on actual timing
-    float getSamplesPerSecond() const {
-        if (totalElapsedTime < 0.1f || sampleCount < 2) return 60.0f;  // Default assumption
-        return static_cast<float>(sampleCount) / totalElapsedTime;
+    long long newestUs() const {
+        return timeUs[(writeIndex + HISTORY_SIZE - 1) % HISTORY_SIZE];
     }
 
-    // Get ordered data for a single metric
-    // Uses actual sample rate to calculate how many samples represent displaySeconds
-    void getOrderedMetric(const float* source, float* out, size_t& outCount) const {
-        float sps = getSamplesPerSecond();
-        size_t samplesForTimeWindow = static_cast<size_t>(displaySeconds * sps);
-        // Cap to available samples
-        outCount = std::min({samplesForTimeWindow, sampleCount, HISTORY_SIZE});
-        if (outCount == 0) return;
-
-        size_t startIdx;
-        if (sampleCount <= outCount) {
-            startIdx = (sampleCount < HISTORY_SIZE) ? 0 : writeIndex;
-            outCount = sampleCount;  // Can only show what we have
-        } else {
-            startIdx = (writeIndex + HISTORY_SIZE - outCount) % HISTORY_SIZE;
+    // Resample a metric onto evenly spaced times ending at `nowUs`. Covers the last
+    // `displaySecs` seconds (the zoom level, or a preview of it while the zoom is being
+    // dragged), or less while the history is shorter than that. Each point stands for the
+    // samples since the previous one (the value held into that span included), so a spike
+    // shorter than a point's spacing is not dropped: a float point takes the bucket's
+    // minimum or maximum, whichever is further from the previous point, and a bit mask
+    // (clock event reasons) ORs the bucket together. A null source (an optional metric
+    // never reported) gives all-zero points.
+    template <typename T>
+    void getOrderedMetric(const T* source, T* out, size_t& outCount, long long nowUs, int displaySecs) const {
+        long long startUs;
+        if (!plotWindow(nowUs, displaySecs, startUs, outCount)) return;
+        if (!source) {
+            std::fill(out, out + outCount, T{});
+            return;
         }
+        size_t oldest = (writeIndex + HISTORY_SIZE - sampleCount) % HISTORY_SIZE;
+        resample(source, timeUs, HISTORY_SIZE, oldest, sampleCount, startUs, nowUs, out, outCount);
+    }
 
+    // Same for a traced metric, over the same window as the slot metrics so that plots
+    // drawn together get the same number of points
+    void getOrderedMetric(const TracedSeries& series, float* out, size_t& outCount, long long nowUs,
+                          int displaySecs) const {
+        long long startUs;
+        if (!plotWindow(nowUs, displaySecs, startUs, outCount)) return;
+        if (series.count == 0) {
+            std::fill(out, out + outCount, 0.0f);
+            return;
+        }
+        size_t oldest = (series.writeIndex + TracedSeries::SIZE - series.count) % TracedSeries::SIZE;
+        resample(series.values.get(), series.timeUs.get(), TracedSeries::SIZE, oldest, series.count,
+                 startUs, nowUs, out, outCount);
+    }
+
+    // Start and number of plot points of the `displaySecs` window ending at `nowUs`; false
+    // (no points) while the history is empty
+    bool plotWindow(long long nowUs, int displaySecs, long long& startUs, size_t& outCount) const {
+        outCount = 0;
+        if (sampleCount == 0) return false;
+
+        size_t oldest = (writeIndex + HISTORY_SIZE - sampleCount) % HISTORY_SIZE;
+        long long windowUs = static_cast<long long>(displaySecs) * 1000000;
+        startUs = std::max(nowUs - windowUs, timeUs[oldest]);
+        if (nowUs <= startUs) return false;
+
+        outCount = std::max<size_t>(2, static_cast<size_t>(
+            PLOT_POINTS * static_cast<double>(nowUs - startUs) / windowUs));
+        outCount = std::min(outCount, PLOT_POINTS);
+        return true;
+    }
+
+    // Bucket `count` time-ordered samples of a ring buffer (starting at `oldest`) onto
+    // `outCount` points from `startUs` to `nowUs`
+    template <typename T>
+    static void resample(const T* source, const long long* times, size_t capacity, size_t oldest, size_t count,
+                         long long startUs, long long nowUs, T* out, size_t outCount) {
+        // Both the points and the samples are in time order, so one forward pass suffices
+        size_t slot = 0;
+        while (slot + 1 < count && times[(oldest + slot + 1) % capacity] <= startUs) {
+            slot++;
+        }
         for (size_t i = 0; i < outCount; i++) {
-            size_t idx = (startIdx + i) % HISTORY_SIZE;
-            out[i] = source[idx];
+            long long t = startUs + static_cast<long long>((nowUs - startUs) * static_cast<double>(i) / (outCount - 1));
+            T low = source[(oldest + slot) % capacity];
+            T high = low;
+            while (slot + 1 < count && times[(oldest + slot + 1) % capacity] <= t) {
+                slot++;
+                T value = source[(oldest + slot) % capacity];
+                if constexpr (std::is_floating_point_v<T>) {
+                    low = std::min(low, value);
+                    high = std::max(high, value);
+                } else {
+                    high |= value;
+                }
+            }
+            if constexpr (std::is_floating_point_v<T>) {
+                T previous = i > 0 ? out[i - 1] : low;
+                out[i] = (high - previous >= previous - low) ? high : low;
+            } else {
+                out[i] = high;
+            }
+        }
+    }
+
+    // Energy used over the `displaySecs` window ending at `nowUs`: the difference between
+    // the counter readings at both ends. False when the counter is not reported or was
+    // reset inside the window.
+    bool windowEnergy(long long nowUs, int displaySecs, double& joules) const {
+        if (sampleCount == 0 || !energyHistory) return false;
+
+        // Slots are in time order: binary search for the first one inside the window
+        size_t oldest = (writeIndex + HISTORY_SIZE - sampleCount) % HISTORY_SIZE;
+        long long startUs = nowUs - static_cast<long long>(displaySecs) * 1000000;
+        size_t lo = 0, hi = sampleCount - 1;
+        while (lo < hi) {
+            size_t mid = (lo + hi) / 2;
+            if (timeUs[(oldest + mid) % HISTORY_SIZE] < startUs) lo = mid + 1; else hi = mid;
         }
+        double first = energyHistory[(oldest + lo) % HISTORY_SIZE];
+        double last = energyHistory[(writeIndex + HISTORY_SIZE - 1) % HISTORY_SIZE];
+        if (first <= 0.0 || last < first) return false;
+        joules = last - first;
+        return true;
     }
 
     void resetZoom() {
@@ -183,14 +332,27 @@ struct GpuRecordedData {
     unsigned int memClockMax = 0;
     unsigned int cudaIndex = 0;
 
-    // Sample pacing
-    float timeSinceLastSample = 0.0f;
+    // Time the clock was held back per ThrottleCause. Summed from the driver's counters
+    // between recorded samples where reported, otherwise from each recorded sample's
+    // reason bits held over the interval since the previous one.
+    std::array<double, THROTTLE_CAUSE_COUNT> throttleSeconds = {};
+    std::array<unsigned long long, THROTTLE_CAUSE_COUNT> throttleLastNs = {};  // Last counter reading
+
+    // Energy used while recording: energy counter deltas between recorded samples, or
+    // power times the sample interval on GPUs without the counter (marked estimated)
+    double energyJ = 0.0;
+    unsigned long long energyLastMj = 0;
+    bool energyEstimated = false;
+
+    // Capture time of the last recorded sample (steady clock, 0 = none yet)
+    long long lastSampleUs = 0;
 };
 
 // Global recording state
 struct RecordingState {
     bool isRecording = false;
     bool showReport = false;
+    long long startUs = 0;     // Steady clock when recording started
     float elapsedTime = 0.0f;
     unsigned long totalSamples = 0;
     std::map<std::string, GpuRecordedData> gpuData;
@@ -198,6 +360,7 @@ struct RecordingState {
     void reset() {
         isRecording = false;
         showReport = false;
+        startUs = 0;
         elapsedTime = 0.0f;
         totalSamples = 0;
         gpuData.clear();
@@ -227,13 +390,15 @@ private:
     GpuConfig* getGpuConfig(const std::string& uuid);
     GpuConfig* getOrCreateGpuConfig(const std::string& uuid);
     std::string getGpuDisplayName(const GpuStats& stats);
-    std::vector<GpuStats> sortGpusByUserOrder(const std::vector<GpuStats>& gpuStats);
+    std::vector<const GpuStats*> sortGpusByUserOrder(const std::vector<GpuStats>& gpuStats);
 
     void renderSystemHealth(const SystemInfo& sysInfo);
+    void renderTopology(const GpuTopology& topology);
     void renderQuickLaunch(const std::vector<GpuStats>& gpuStats);
     void renderGpuCard(const GpuStats& stats, const std::vector<GpuStats>& allStats, int index);
     void renderBadge(const char* text, bool isTCC);
     void renderProcessesSection(const GpuStats& stats);
+    void renderMigInstances(const GpuStats& stats);  // Nested sub-card per MIG instance
     void renderCommandsSection(const GpuStats& stats, const std::vector<GpuStats>& allStats);
     void renderConfirmDialog();
 
@@ -242,10 +407,14 @@ private:
     void renderRecordReport();
     std::string formatRecordReportText() const;
 
+    // Driver call latency window
+    void renderDiagnostics(const std::vector<GpuStats>& gpuStats, const SystemInfo& sysInfo);
+    std::string formatDiagnosticsText(const std::vector<GpuStats>& gpuStats, const SystemInfo& sysInfo) const;
+
     // Drag-drop functions
     void renderDragHandle(const GpuStats& stats, const std::string& displayName, int index);
     void renderDropIndicator(int targetIndex);
-    void commitReorder(int sourceIndex, int targetIndex, const std::vector<GpuStats>& sortedStats);
+    void commitReorder(int sourceIndex, int targetIndex, const std::vector<const GpuStats*>& sortedStats);
     GpuCardState& getCardState(const std::string& uuid);
     void killProcess(unsigned int pid);
     std::string buildGpuSelectionString(const QuickLaunchPreset& preset, const std::vector<GpuStats>& gpuStats);
@@ -293,8 +462,29 @@ private:
     RecordingState m_recording;
     float m_recordPulseTimer = 0.0f;
 
+    // Diagnostics window open
+    bool m_showDiagnostics = false;
+
+    // One sparkline in a compact metrics row
+    struct SparklineMetric {
+        const char* label;
+        const char* valueStr;      // Pre-formatted value string
+        float frac;                // Current value, 0-1 (health color)
+        const float* data;         // Resampled history, 0-1
+        const char* sparkId;
+        const char* detail = nullptr;  // Extra tooltip text
+        const unsigned int* events = nullptr;  // ClockEventReason bits per point, shown as a strip below
+    };
+
+    // Seconds a GPU's sparklines show: its zoom level, or the preview while it is dragged
+    int displaySecondsFor(const std::string& uuid) const;
+
     // Render compact metrics section with sparklines (grid layout)
     void renderCompactMetrics(const GpuStats& stats);
+    void renderInterconnectMetrics(const GpuStats& stats);  // PCIe and NVLink throughput
+    void renderProfilingMetrics(const GpuStats& stats);     // GPM SM, tensor and DRAM activity
+    void renderSparklineRow(const GpuStats& stats, std::span<const SparklineMetric> metrics,
+                            size_t dataCount, int displaySecs);
 
     // Get health status for a single metric: 0=green, 1=yellow, 2=red
     int getMetricHealth(float frac);      // For Power/Core/Mem (70%/90% thresholds)
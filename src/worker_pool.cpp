@@ -0,0 +1,80 @@
+#include "worker_pool.h"
+
+WorkerPool::WorkerPool(unsigned int size) {
+    if (size < 1) size = 1;
+    m_threads.reserve(size - 1);
+    for (unsigned int i = 1; i < size; i++) {
+        m_threads.emplace_back([this](std::stop_token stopToken) {
+            workerThread(stopToken);
+        });
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    for (auto& thread : m_threads) {
+        thread.request_stop();
+    }
+    m_threads.clear();  // Joins; condition_variable_any wakes on stop request
+}
+
+void WorkerPool::run(size_t count, const std::function<void(size_t)>& task) {
+    if (count == 0) return;
+
+    // Nothing to hand off: run inline without touching the workers
+    if (m_threads.empty() || count == 1) {
+        for (size_t i = 0; i < count; i++) task(i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_task = &task;
+        m_count = count;
+        m_next.store(0, std::memory_order_relaxed);
+        m_remaining = count;
+        m_active = 1;  // The calling thread
+        m_generation++;
+    }
+    m_wake.notify_all();
+
+    drain();
+
+    // Wait for every task to finish and every joined worker to leave drain(), so the
+    // batch state is not reset while a worker is still reading it
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this] { return m_remaining == 0 && m_active == 0; });
+    m_task = nullptr;
+}
+
+void WorkerPool::drain() {
+    size_t completed = 0;
+    for (size_t i = m_next.fetch_add(1, std::memory_order_relaxed); i < m_count;
+         i = m_next.fetch_add(1, std::memory_order_relaxed)) {
+        (*m_task)(i);
+        completed++;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_remaining -= completed;
+    m_active--;
+    if (m_remaining == 0 && m_active == 0) {
+        m_done.notify_all();
+    }
+}
+
+void WorkerPool::workerThread(std::stop_token stopToken) {
+    unsigned long long seenGeneration = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (!m_wake.wait(lock, stopToken, [&] { return m_generation != seenGeneration; })) {
+                return;  // Stop requested
+            }
+            seenGeneration = m_generation;
+            // Woke too late: the caller already finished this batch on its own
+            if (m_remaining == 0) continue;
+            m_active++;
+        }
+        drain();
+    }
+}
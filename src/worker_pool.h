@@ -0,0 +1,45 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+// Fixed-size pool that runs an indexed batch of tasks and waits for all of them.
+// The calling thread takes part in every batch, so a pool of size 1 spawns no
+// threads and runs the batch inline.
+class WorkerPool {
+public:
+    explicit WorkerPool(unsigned int size);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    unsigned int size() const { return static_cast<unsigned int>(m_threads.size()) + 1; }
+
+    // Call task(i) for every i in [0, count) and return once all calls have finished.
+    // Not reentrant: only one batch may run at a time.
+    void run(size_t count, const std::function<void(size_t)>& task);
+
+private:
+    void workerThread(std::stop_token stopToken);
+    void drain();
+
+    std::vector<std::jthread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable_any m_wake;
+    std::condition_variable m_done;
+
+    // Current batch (written under m_mutex before m_generation is bumped)
+    const std::function<void(size_t)>* m_task{nullptr};
+    size_t m_count{0};
+    std::atomic<size_t> m_next{0};
+    size_t m_remaining{0};       // Tasks not yet finished
+    unsigned int m_active{0};    // Workers still inside drain()
+    unsigned long long m_generation{0};
+};